@@ -0,0 +1,335 @@
+#define _POSIX_C_SOURCE 200112L /* for posix_memalign */
+#include <stddef.h> /* for size_t */
+#include <stdint.h> /* for uint64_t */
+#include <stdlib.h> /* for posix_memalign */
+#include <string.h> /* for memcpy */
+#include <assert.h> /* for assert */
+
+#include "dary_heap.h"
+
+#define DARY_HEAP_CACHE_LINE (64)
+#define DARY_HEAP_DEFAULT_ARITY (4)
+#define DARY_HEAP_MAX_ARITY (16)
+#define DARY_HEAP_INITIAL_CAPACITY (64)
+
+/* Node i of the heap is at slots[i + pad], pad = arity - 1, so the
+   children of node i (arity * i + 1 ...) start at slot arity * (i + 1),
+   which is on a cache line (the slots are aligned to one, and
+   arity * sizeof(entry) is a multiple of the line, or a divisor of it). */
+
+typedef struct dary_heap_entry
+{
+	uint64_t key;
+	void *payload;
+} dary_heap_entry_t;
+
+struct dary_heap
+{
+	dary_heap_entry_t *slots;
+	dary_heap_entry_t *nodes;		/* slots + pad - node 0 is the root */
+	size_t arity;
+	size_t size;
+	size_t capacity;				/* in nodes */
+};
+
+/*******************************************************************************
+AllocSlots() - helper function - cache line aligned slots for capacity nodes.
+			   Returns NULL on failure.
+*******************************************************************************/
+static dary_heap_entry_t *AllocSlots(size_t arity, size_t capacity)
+{
+	void *res = NULL;
+
+	if (0 != posix_memalign(&res, DARY_HEAP_CACHE_LINE,
+							(capacity + arity - 1) * sizeof(dary_heap_entry_t)))
+	{
+		return (NULL);
+	}
+
+	return ((dary_heap_entry_t *)res);
+}
+
+/*******************************************************************************
+Grow() - helper function - doubles the capacity.
+		 returns 0 on success, 1 on failure (the heap is unchanged).
+
+Time complexity: O(n).
+*******************************************************************************/
+static int Grow(dary_heap_t *heap)
+{
+	dary_heap_entry_t *slots = AllocSlots(heap->arity, 2 * heap->capacity);
+
+	if (NULL == slots)
+	{
+		return (1);
+	}
+
+	memcpy(slots + heap->arity - 1, heap->nodes,
+		   heap->size * sizeof(dary_heap_entry_t));
+	free(heap->slots);
+
+	heap->slots = slots;
+	heap->nodes = slots + heap->arity - 1;
+	heap->capacity *= 2;
+
+	return (0);
+}
+
+/*******************************************************************************
+SiftDown() - helper function - places entry at the hole at index, moving the
+			 least child up while it is less than entry.
+			 All the children of a node are on one cache line (or two).
+
+Time complexity: O(arity * log n / log arity).
+*******************************************************************************/
+static void SiftDown(dary_heap_t *heap, size_t index, dary_heap_entry_t entry)
+{
+	dary_heap_entry_t *nodes = heap->nodes;
+	size_t arity = heap->arity;
+	size_t size = heap->size;
+	size_t first = 0;
+
+	while ((first = (arity * index) + 1) < size)
+	{
+		size_t last = first + arity;
+		size_t least = first;
+		size_t i = 0;
+
+		if (last > size)
+		{
+			last = size;
+		}
+
+		for (i = first + 1; i < last; ++i)
+		{
+			if (nodes[i].key < nodes[least].key)
+			{
+				least = i;
+			}
+		}
+
+		if (nodes[least].key >= entry.key)
+		{
+			break;
+		}
+
+		nodes[index] = nodes[least];
+		index = least;
+	}
+
+	nodes[index] = entry;
+}
+
+/*******************************************************************************
+DaryHeapCreate() - creates a heap and returns a pointer to it,
+				   or NULL on failure.
+*******************************************************************************/
+dary_heap_t *DaryHeapCreate(size_t arity)
+{
+	dary_heap_t *res = NULL;
+
+	if (0 == arity)
+	{
+		arity = DARY_HEAP_DEFAULT_ARITY;
+	}
+
+	assert((arity >= 2) && (arity <= DARY_HEAP_MAX_ARITY));
+	assert(0 == (arity & (arity - 1)));
+
+	res = (dary_heap_t *)malloc(sizeof(*res));
+	if (NULL == res)
+	{
+		return (NULL);
+	}
+
+	res->slots = AllocSlots(arity, DARY_HEAP_INITIAL_CAPACITY);
+	if (NULL == res->slots)
+	{
+		free(res); res = NULL;
+		return (NULL);
+	}
+
+	res->nodes = res->slots + arity - 1;
+	res->arity = arity;
+	res->size = 0;
+	res->capacity = DARY_HEAP_INITIAL_CAPACITY;
+
+	return (res);
+}
+
+/*******************************************************************************
+DaryHeapDestroy() - frees the heap (not the payloads).
+
+Time complexity: O(1).
+*******************************************************************************/
+void DaryHeapDestroy(dary_heap_t *heap)
+{
+	assert(heap != NULL);
+
+	free(heap->slots); heap->slots = NULL;
+	free(heap); heap = NULL;
+}
+
+/*******************************************************************************
+DaryHeapSize() - return the num of entries held in heap.
+
+Time complexity: O(1).
+*******************************************************************************/
+size_t DaryHeapSize(const dary_heap_t *heap)
+{
+	assert(heap != NULL);
+
+	return (heap->size);
+}
+
+/*******************************************************************************
+DaryHeapIsempty() - return 1 if heap is empty, or 0 otherwise.
+
+Time complexity: O(1).
+*******************************************************************************/
+int DaryHeapIsempty(const dary_heap_t *heap)
+{
+	assert(heap != NULL);
+
+	return (0 == heap->size);
+}
+
+/*******************************************************************************
+DaryHeapPush() - inserts an entry.
+			   - returns 0 on sucess or 1 on failure
+
+Time complexity: O(log n / log arity), O(n) when the array grows.
+*******************************************************************************/
+int DaryHeapPush(dary_heap_t *heap, uint64_t key, void *payload)
+{
+	dary_heap_entry_t *nodes = NULL;
+	size_t index = 0;
+
+	assert(heap != NULL);
+
+	if ((heap->size == heap->capacity) && (0 != Grow(heap)))
+	{
+		return (1);
+	}
+
+	nodes = heap->nodes;
+	index = heap->size;
+	++heap->size;
+
+	while (index > 0)
+	{
+		size_t parent = (index - 1) / heap->arity;
+
+		if (nodes[parent].key <= key)
+		{
+			break;
+		}
+
+		nodes[index] = nodes[parent];
+		index = parent;
+	}
+
+	nodes[index].key = key;
+	nodes[index].payload = payload;
+
+	return (0);
+}
+
+/*******************************************************************************
+DaryHeapPop() - removes the least entry into key and payload.
+			  - returns 0 on sucess or 1 if the heap is empty
+
+Time complexity: O(arity * log n / log arity).
+*******************************************************************************/
+int DaryHeapPop(dary_heap_t *heap, uint64_t *key, void **payload)
+{
+	assert(heap != NULL);
+
+	if (0 != DaryHeapPeek(heap, key, payload))
+	{
+		return (1);
+	}
+
+	--heap->size;
+	if (0 != heap->size)
+	{
+		SiftDown(heap, 0, heap->nodes[heap->size]);
+	}
+
+	return (0);
+}
+
+/*******************************************************************************
+DaryHeapPeek() - copies the least entry into key and payload.
+			   - returns 0 on sucess or 1 if the heap is empty
+
+Time complexity: O(1).
+*******************************************************************************/
+int DaryHeapPeek(const dary_heap_t *heap, uint64_t *key, void **payload)
+{
+	assert(heap != NULL);
+
+	if (0 == heap->size)
+	{
+		return (1);
+	}
+
+	if (NULL != key)
+	{
+		*key = heap->nodes[0].key;
+	}
+
+	if (NULL != payload)
+	{
+		*payload = heap->nodes[0].payload;
+	}
+
+	return (0);
+}
+
+/*******************************************************************************
+DaryHeapClear() - removes all the entries. The capacity doesn't change.
+
+Time complexity: O(1).
+*******************************************************************************/
+void DaryHeapClear(dary_heap_t *heap)
+{
+	assert(heap != NULL);
+
+	heap->size = 0;
+}
+
+/*******************************************************************************
+DaryHeapKeyFromDouble() - maps value to a key of the same order: the sign bit
+						  of a positive value is set, all the bits of a
+						  negative one are flipped.
+
+Time complexity: O(1).
+*******************************************************************************/
+uint64_t DaryHeapKeyFromDouble(double value)
+{
+	uint64_t bits = 0;
+	const uint64_t sign = (uint64_t)1 << 63;
+
+	assert(sizeof(bits) == sizeof(value));
+
+	memcpy(&bits, &value, sizeof(bits));
+
+	return ((0 != (bits & sign)) ? ~bits : (bits | sign));
+}
+
+/*******************************************************************************
+DaryHeapKeyToDouble() - the value of a key of DaryHeapKeyFromDouble.
+
+Time complexity: O(1).
+*******************************************************************************/
+double DaryHeapKeyToDouble(uint64_t key)
+{
+	double value = 0;
+	const uint64_t sign = (uint64_t)1 << 63;
+
+	key = (0 != (key & sign)) ? (key & ~sign) : ~key;
+	memcpy(&value, &key, sizeof(value));
+
+	return (value);
+}
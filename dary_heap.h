@@ -0,0 +1,42 @@
+#ifndef DARY_HEAP_H_
+#define DARY_HEAP_H_
+
+#include <stddef.h> /* size_t */
+#include <stdint.h> /* uint64_t */
+
+/* Min-heap of {key, payload} entries, held inline in one array and
+   ordered by comparing the keys directly (no is_before call, and the
+   payloads are never read). Every node has arity children, laid out
+   so that all the siblings start on a cache line: with the default
+   arity of 4 they fill exactly one line. */
+
+typedef struct dary_heap dary_heap_t;
+
+/* arity: a power of 2 up to 16, or 0 for the default (4).
+   returns NULL on failure */
+dary_heap_t *DaryHeapCreate(size_t arity);
+
+void DaryHeapDestroy(dary_heap_t *heap);
+
+size_t DaryHeapSize(const dary_heap_t *heap);
+
+int DaryHeapIsempty(const dary_heap_t *heap);
+
+/* returns 0 on success, 1 on failure */
+int DaryHeapPush(dary_heap_t *heap, uint64_t key, void *payload);
+
+/* copies the least entry to key and payload (either may be NULL) and
+   removes it. returns 0 on success, 1 if the heap is empty */
+int DaryHeapPop(dary_heap_t *heap, uint64_t *key, void **payload);
+
+/* like DaryHeapPop, without removing. returns 1 if the heap is empty */
+int DaryHeapPeek(const dary_heap_t *heap, uint64_t *key, void **payload);
+
+void DaryHeapClear(dary_heap_t *heap);
+
+/* keys of doubles: a < b if and only if DaryHeapKeyFromDouble(a) <
+   DaryHeapKeyFromDouble(b) (-0.0 is before 0.0, NaNs are not supported) */
+uint64_t DaryHeapKeyFromDouble(double value);
+double DaryHeapKeyToDouble(uint64_t key);
+
+#endif /* DARY_HEAP_H_ */
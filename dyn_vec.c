@@ -1,15 +1,59 @@
+#if defined(__linux__)
+#define _GNU_SOURCE /* for mremap */
+#define DYN_VEC_USE_MREMAP
+#endif
+
 #include <stdlib.h> /* for malloc */
 #include <assert.h> /* for assert */
 #include <string.h> /* for memcpy */
 
+#ifdef DYN_VEC_USE_MREMAP
+#include <sys/mman.h> /* for mmap, mremap */
+#include <sys/stat.h> /* for fstat */
+#include <fcntl.h> /* for open */
+#include <unistd.h> /* for ftruncate */
+#endif
+
 #include "dyn_vec.h"
 
+
+/* vectors of at least this many bytes live in their own mapping,
+   so growing them is a page-table move (mremap) instead of a copy */
+#define DYN_VEC_MAP_THRESHOLD ((size_t)64 * 1024 * 1024)
+
+/* file-backed vec: the header, then the items */
+#define DYN_VEC_FILE_MAGIC (0x444E5956UL) /* "DNYV" */
+#define DYN_VEC_FILE_VERSION (1)
+#define DYN_VEC_FILE_HEADER_SIZE (64) /* keeps the items aligned */
+#define DYN_VEC_FILE_MIN_BYTES ((size_t)4096)
+
+enum dyn_vec_storage
+{
+	DYN_VEC_HEAP = 0,		/* malloc / realloc */
+	DYN_VEC_ANON_MAP = 1,	/* private mapping, grows by mremap */
+	DYN_VEC_FILE_MAP = 2	/* shared file mapping, ftruncate + mremap */
+};
+
+struct dyn_vec_file_header
+{
+	unsigned long magic;
+	unsigned long version;
+	unsigned long item_size;
+	unsigned long count;	/* updated on flush and destroy */
+	unsigned long capacity;
+};
+
 struct dyn_vec
 {
 	size_t item_size;
 	size_t num_items;
 	void *top; /* top of the vec */
 	void *start; 
+	size_t min_items;		/* capacity on create, auto shrink stops here */
+	size_t growth_percent;	/* 200 means the capacity doubles */
+	size_t shrink_divisor;	/* 0 means no auto shrink on PopBack */
+	enum dyn_vec_storage storage;
+	int fd;					/* the file of DYN_VEC_FILE_MAP, or -1 */
 };
 
 /****************************************************************
@@ -47,10 +91,29 @@ dyn_vec_t *DynVecCreate(size_t item_size, size_t num_items)
 	new_dyn_vec->start = tmp;
 	new_dyn_vec->item_size = item_size;
 	new_dyn_vec->num_items = num_items;
+	new_dyn_vec->min_items = num_items;
+	new_dyn_vec->growth_percent = DYN_VEC_DEFAULT_GROWTH_PERCENT;
+	new_dyn_vec->shrink_divisor = 0;
+	new_dyn_vec->storage = DYN_VEC_HEAP;
+	new_dyn_vec->fd = -1;
 
 	return (new_dyn_vec);
 }
 
+#ifdef DYN_VEC_USE_MREMAP
+/****************************************************************
+Helper function - the header in front of the items of a 
+file-backed vec
+****************************************************************/
+static struct dyn_vec_file_header *DynVecFileHeader(const dyn_vec_t *vec)
+{
+	assert(DYN_VEC_FILE_MAP == vec->storage);
+
+	return ((struct dyn_vec_file_header *)
+			((char *)vec->start - DYN_VEC_FILE_HEADER_SIZE));
+}
+#endif
+
 /****************************************************************
 Destroy the Stack and free the memory
 ****************************************************************/
@@ -58,7 +121,26 @@ void DynVecDestroy(dyn_vec_t *vec)
 {
 	assert(vec != NULL);
 	
-	free(vec->start);
+#ifdef DYN_VEC_USE_MREMAP
+	if (DYN_VEC_FILE_MAP == vec->storage)
+	{
+		struct dyn_vec_file_header *header = DynVecFileHeader(vec);
+
+		/* the pages stay in the page cache and reach the file later */
+		header->count = DynVecSize(vec);
+		munmap(header, DYN_VEC_FILE_HEADER_SIZE + 
+					   vec->num_items * vec->item_size);
+		close(vec->fd);
+	}
+	else if (DYN_VEC_ANON_MAP == vec->storage)
+	{
+		munmap(vec->start, vec->num_items * vec->item_size);
+	}
+	else
+#endif
+	{
+		free(vec->start);
+	}
 	vec->start = NULL;
 
 	free(vec);
@@ -75,6 +157,148 @@ size_t DynVecSize(const dyn_vec_t *vec)
 	return(((size_t)vec->top - (size_t)vec->start) / vec->item_size);
 }
 
+/****************************************************************
+Return the size in bytes of one item
+****************************************************************/
+size_t DynVecItemSize(const dyn_vec_t *vec)
+{
+	assert(vec != NULL);
+
+	return (vec->item_size);
+}
+
+/****************************************************************
+Helper function - the capacity that follows "capacity" according
+to growth_percent, at least one item more.
+****************************************************************/
+static size_t DynVecGrownCapacity(const dyn_vec_t *vec, size_t capacity)
+{
+	return (DYN_VEC_GROWN_CAPACITY(capacity, vec->growth_percent));
+}
+
+#ifdef DYN_VEC_USE_MREMAP
+/****************************************************************
+Helper function - resizes the file and its mapping to hold
+new_capacity items. The file grows before the mapping and 
+shrinks after it, so the mapping never passes the end of file.
+return 0 if sucsses, and 1 if fail.
+****************************************************************/
+static int DynVecResizeFile(dyn_vec_t *vec, size_t new_capacity)
+{
+	size_t size = DynVecSize(vec);
+	size_t old_bytes = DYN_VEC_FILE_HEADER_SIZE + 
+					   vec->num_items * vec->item_size;
+	size_t new_bytes = DYN_VEC_FILE_HEADER_SIZE + 
+					   new_capacity * vec->item_size;
+	struct dyn_vec_file_header *header = DynVecFileHeader(vec);
+
+	if ((new_bytes > old_bytes) && 
+		(0 != ftruncate(vec->fd, (off_t)new_bytes)))
+	{
+		return (1);
+	}
+
+	header = (struct dyn_vec_file_header *)mremap(header, old_bytes, 
+												  new_bytes, MREMAP_MAYMOVE);
+	if (MAP_FAILED == (void *)header)
+	{
+		if (new_bytes > old_bytes)
+		{
+			/* the file must keep matching header->capacity */
+			ftruncate(vec->fd, (off_t)old_bytes);
+		}
+
+		return (1);
+	}
+
+	if (new_bytes < old_bytes)
+	{
+		/* on failure the file just keeps a tail that isn't used */
+		ftruncate(vec->fd, (off_t)new_bytes);
+	}
+
+	header->capacity = new_capacity;
+	vec->start = (char *)header + DYN_VEC_FILE_HEADER_SIZE;
+	vec->top = (char *)vec->start + (size * vec->item_size);
+
+	return (0);
+}
+#endif
+
+/****************************************************************
+Helper function - moves the items to a storage of new_capacity.
+Small vectors use realloc, large ones (DYN_VEC_MAP_THRESHOLD)
+use a private mapping that grows and shrinks with mremap, 
+without copying the items.
+return 0 if sucsses, and 1 if fail.
+****************************************************************/
+static int DynVecResizeStorage(dyn_vec_t *vec, size_t new_capacity)
+{
+	size_t size = DynVecSize(vec);
+	size_t new_bytes = new_capacity * vec->item_size;
+	void *new_start = NULL;
+
+	assert(new_capacity >= size);
+	assert(new_capacity > 0);
+
+#ifdef DYN_VEC_USE_MREMAP
+	if (DYN_VEC_FILE_MAP == vec->storage)
+	{
+		if (DynVecResizeFile(vec, new_capacity))
+		{
+			return (1);
+		}
+		new_start = vec->start;
+	}
+	else if (DYN_VEC_ANON_MAP == vec->storage)
+	{
+		new_start = mremap(vec->start, vec->num_items * vec->item_size,
+						   new_bytes, MREMAP_MAYMOVE);
+		if (MAP_FAILED == new_start)
+		{
+			return (1);
+		}
+	}
+	else if (new_bytes >= DYN_VEC_MAP_THRESHOLD)
+	{
+		new_start = mmap(NULL, new_bytes, PROT_READ | PROT_WRITE,
+						 MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+		if (MAP_FAILED == new_start)
+		{
+			return (1);
+		}
+
+		/* last copy of the items - from now on mremap moves pages */
+		memcpy(new_start, vec->start, size * vec->item_size);
+		free(vec->start);
+		vec->storage = DYN_VEC_ANON_MAP;
+	}
+	else
+#endif
+	{
+		new_start = realloc(vec->start, new_bytes);
+		if (NULL == new_start)
+		{
+			return (1);
+		}
+	}
+
+#if defined(DYN_VEC_USE_MREMAP) && defined(MADV_HUGEPAGE)
+	if (DYN_VEC_ANON_MAP == vec->storage)
+	{
+		/* only a hint, ignore failure */
+		madvise(new_start, new_bytes, MADV_HUGEPAGE);
+	}
+#endif
+
+	/* Initializing destarts of the dyn_vec */
+	vec->top = (void *)((size_t)new_start + (size * vec->item_size));
+	vec->start = new_start;
+	vec->num_items = new_capacity; 
+
+	return (0);
+}
+
 /****************************************************************
 Inserts an item at the top of the dyn_vec.
 return 0 if sucsses, and 1 if fail.
@@ -87,7 +311,7 @@ int DynVecPushBack(dyn_vec_t *vec, const void *item)
 	/* if there are overflowe - realloc */
 	if (DynVecSize(vec) == DynVecCapacity(vec))
 	{
-		int tmp = DynVecReserve(vec, vec->num_items * 2);
+		int tmp = DynVecReserve(vec, DynVecGrownCapacity(vec, vec->num_items));
 	
 		if(tmp)
 		{
@@ -109,6 +333,17 @@ void DynVecPopBack(dyn_vec_t *vec)
 	assert(vec != NULL);
 	
 	vec->top = (void *)((size_t)vec->top - vec->item_size);
+
+	/* hysteresis: shrink to half only when 1 / shrink_divisor is used
+	   (off unless DynVecSetShrinkThreshold was called), so push/pop at
+	   the boundary doesn't realloc every time */
+	if ((vec->shrink_divisor != 0) &&
+		(DynVecSize(vec) * vec->shrink_divisor <= vec->num_items) &&
+		(vec->num_items / 2 >= vec->min_items))
+	{
+		/* on failure the vec just stays larger */
+		DynVecResizeStorage(vec, vec->num_items / 2);
+	}
 }
 
 /****************************************************************
@@ -138,23 +373,358 @@ and increase the dyn_vec as a new_capacity size
 ****************************************************************/
 int DynVecReserve(dyn_vec_t *vec, size_t new_capacity)
 {
-	void *new_start = NULL;
-	
-	assert(vec->num_items < new_capacity);
 	assert(vec != NULL);
+	assert(vec->num_items < new_capacity);
 		
-	/* memory allocation for dyn_vec */	
-	new_start = realloc(vec->start, new_capacity * vec->item_size);
-	if(NULL == new_start)
+	return (DynVecResizeStorage(vec, new_capacity));
+}
+
+/****************************************************************
+set the growth factor of PushBack, in percent of the capacity
+(150 grows by 1.5, the default 200 doubles)
+****************************************************************/
+void DynVecSetGrowthFactor(dyn_vec_t *vec, size_t growth_percent)
+{
+	assert(vec != NULL);
+	assert(growth_percent > 100);
+
+	vec->growth_percent = growth_percent;
+}
+
+/****************************************************************
+PopBack halves the capacity when the size drops to 
+capacity / divisor, but never below the capacity from create.
+divisor 0 disables it (the default). divisor must be 0 or > 2,
+otherwise a shrink is followed by a grow on the next push.
+****************************************************************/
+void DynVecSetShrinkThreshold(dyn_vec_t *vec, size_t divisor)
+{
+	assert(vec != NULL);
+	assert((0 == divisor) || (divisor > 2));
+
+	vec->shrink_divisor = divisor;
+}
+
+/****************************************************************
+reduce the capacity to the num of items (at least 1 item)
+return 0 if sucsses, and 1 if fail.
+****************************************************************/
+int DynVecShrinkToFit(dyn_vec_t *vec)
+{
+	size_t size = 0;
+
+	assert(vec != NULL);
+
+	size = DynVecSize(vec);
+	if (0 == size)
+	{
+		size = 1;
+	}
+
+	if (size == vec->num_items)
+	{
+		return (0);
+	}
+
+	return (DynVecResizeStorage(vec, size));
+}
+
+/****************************************************************
+Helper function - makes room for "needed" items in total,
+growing by growth_percent as many times as needed, with a 
+single reallocation.
+return 0 if sucsses, and 1 if fail.
+****************************************************************/
+static int DynVecReserveFor(dyn_vec_t *vec, size_t needed)
+{
+	size_t new_capacity = vec->num_items;
+
+	if (needed <= new_capacity)
+	{
+		return (0);
+	}
+
+	while (new_capacity < needed)
+	{
+		new_capacity = DynVecGrownCapacity(vec, new_capacity);
+	}
+
+	return (DynVecResizeStorage(vec, new_capacity));
+}
+
+/****************************************************************
+Inserts n items at the top of the dyn_vec, with one memcpy.
+return 0 if sucsses, and 1 if fail.
+****************************************************************/
+int DynVecPushBackN(dyn_vec_t *vec, const void *items, size_t n)
+{
+	assert(vec != NULL);
+	assert((items != NULL) || (0 == n));
+
+	if (DynVecReserveFor(vec, DynVecSize(vec) + n))
 	{
 		return (1);
 	}
-	
-	/* Initializing destarts of the dyn_vec */
-	vec->top = (void *)((size_t)new_start + (DynVecSize(vec) * vec->item_size));
-	vec->start = new_start;
-	vec->num_items = new_capacity; 
-	
+
+	memcpy(vec->top, items, n * vec->item_size);
+	vec->top = (void *)((size_t)vec->top + (n * vec->item_size));
+
+	return (0);
+}
+
+/****************************************************************
+Inserts n items before the item at index (index == size appends).
+The items after index are moved with one memmove.
+return 0 if sucsses, and 1 if fail.
+****************************************************************/
+int DynVecInsertRange(dyn_vec_t *vec, size_t index, const void *items, 
+					  size_t n)
+{
+	size_t size = 0;
+	char *where = NULL;
+
+	assert(vec != NULL);
+	assert((items != NULL) || (0 == n));
+	assert(index <= DynVecSize(vec));
+
+	size = DynVecSize(vec);
+	if (DynVecReserveFor(vec, size + n))
+	{
+		return (1);
+	}
+
+	where = (char *)vec->start + (index * vec->item_size);
+	memmove(where + (n * vec->item_size), where, 
+			(size - index) * vec->item_size);
+	memcpy(where, items, n * vec->item_size);
+	vec->top = (void *)((size_t)vec->top + (n * vec->item_size));
+
+	return (0);
+}
+
+/****************************************************************
+Removes n items starting at index.
+The items after the range are moved with one memmove.
+****************************************************************/
+void DynVecEraseRange(dyn_vec_t *vec, size_t index, size_t n)
+{
+	char *where = NULL;
+	size_t size = 0;
+
+	assert(vec != NULL);
+	assert(index + n <= DynVecSize(vec));
+
+	size = DynVecSize(vec);
+	where = (char *)vec->start + (index * vec->item_size);
+	memmove(where, where + (n * vec->item_size), 
+			(size - index - n) * vec->item_size);
+	vec->top = (void *)((size_t)vec->top - (n * vec->item_size));
+}
+
+/****************************************************************
+Sets the num of the items to new_size.
+New items are zeroed, like the items of DynVecCreate.
+return 0 if sucsses, and 1 if fail.
+****************************************************************/
+int DynVecResize(dyn_vec_t *vec, size_t new_size)
+{
+	size_t size = 0;
+
+	assert(vec != NULL);
+
+	size = DynVecSize(vec);
+	if (new_size > size)
+	{
+		if (DynVecReserveFor(vec, new_size))
+		{
+			return (1);
+		}
+
+		memset(vec->top, 0, (new_size - size) * vec->item_size);
+	}
+
+	vec->top = (void *)((size_t)vec->start + (new_size * vec->item_size));
+
 	return (0);
 }
 
+/****************************************************************
+Removes all the items. The capacity doesn't change.
+****************************************************************/
+void DynVecClear(dyn_vec_t *vec)
+{
+	assert(vec != NULL);
+
+	vec->top = vec->start;
+}
+
+#ifdef DYN_VEC_USE_MREMAP
+/****************************************************************
+Helper function for DynVecOpenMapped - maps an open file,
+creating the header if the file is empty.
+return the header, or NULL if the file is not a dyn_vec file of 
+item_size items.
+****************************************************************/
+static struct dyn_vec_file_header *DynVecMapFile(int fd, size_t item_size)
+{
+	struct dyn_vec_file_header *header = NULL;
+	struct stat file_stat;
+	size_t bytes = 0;
+	size_t capacity = 0;
+	int is_new = 0;
+
+	if (0 != fstat(fd, &file_stat))
+	{
+		return (NULL);
+	}
+
+	bytes = (size_t)file_stat.st_size;
+	if (0 == bytes)
+	{
+		is_new = 1;
+		capacity = (DYN_VEC_FILE_MIN_BYTES - DYN_VEC_FILE_HEADER_SIZE) / 
+				   item_size;
+		if (0 == capacity)
+		{
+			capacity = 1;
+		}
+
+		/* the file holds exactly capacity items */
+		bytes = DYN_VEC_FILE_HEADER_SIZE + capacity * item_size;
+		if (0 != ftruncate(fd, (off_t)bytes))
+		{
+			return (NULL);
+		}
+	}
+	else if (bytes < DYN_VEC_FILE_HEADER_SIZE + item_size)
+	{
+		return (NULL);
+	}
+
+	header = (struct dyn_vec_file_header *)mmap(NULL, bytes, 
+									PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+	if (MAP_FAILED == (void *)header)
+	{
+		if (is_new)
+		{
+			ftruncate(fd, 0);
+		}
+
+		return (NULL);
+	}
+
+	if (is_new)
+	{
+		header->magic = DYN_VEC_FILE_MAGIC;
+		header->version = DYN_VEC_FILE_VERSION;
+		header->item_size = item_size;
+		header->count = 0;
+		header->capacity = capacity;
+	}
+
+	/* the header must match the file and the caller */
+	if ((header->magic != DYN_VEC_FILE_MAGIC) ||
+		(header->version != DYN_VEC_FILE_VERSION) ||
+		(header->item_size != item_size) ||
+		(0 == header->capacity) ||
+		(header->count > header->capacity) ||
+		(DYN_VEC_FILE_HEADER_SIZE + header->capacity * item_size != bytes))
+	{
+		munmap(header, bytes);
+		if (is_new)
+		{
+			/* leave the file empty, as it was */
+			ftruncate(fd, 0);
+		}
+
+		return (NULL);
+	}
+
+	return (header);
+}
+#endif
+
+/****************************************************************
+Opens a dyn_vec stored in the file at path (created if missing,
+then the vec is empty). The items are mapped shared - no load,
+and processes that map the same file share the page cache.
+Growing uses ftruncate + mremap, DynVecDestroy unmaps and closes.
+return NULL if fail, or if the file holds another item_size.
+****************************************************************/
+dyn_vec_t *DynVecOpenMapped(const char *path, size_t item_size)
+{
+#ifdef DYN_VEC_USE_MREMAP
+	dyn_vec_t *new_dyn_vec = NULL;
+	struct dyn_vec_file_header *header = NULL;
+	int fd = -1;
+
+	assert(path != NULL);
+	assert(item_size);
+
+	new_dyn_vec = (dyn_vec_t *)malloc(sizeof(dyn_vec_t));
+	if (NULL == new_dyn_vec)
+	{
+		return (NULL);
+	}
+
+	fd = open(path, O_RDWR | O_CREAT, 0644);
+	if (-1 == fd)
+	{
+		free(new_dyn_vec); new_dyn_vec = NULL;
+		return (NULL);
+	}
+
+	header = DynVecMapFile(fd, item_size);
+	if (NULL == header)
+	{
+		close(fd);
+		free(new_dyn_vec); new_dyn_vec = NULL;
+		return (NULL);
+	}
+
+	new_dyn_vec->item_size = item_size;
+	new_dyn_vec->num_items = header->capacity;
+	new_dyn_vec->start = (char *)header + DYN_VEC_FILE_HEADER_SIZE;
+	new_dyn_vec->top = (char *)new_dyn_vec->start + 
+					   (header->count * item_size);
+	new_dyn_vec->min_items = 1;
+	new_dyn_vec->growth_percent = DYN_VEC_DEFAULT_GROWTH_PERCENT;
+	new_dyn_vec->shrink_divisor = 0;
+	new_dyn_vec->storage = DYN_VEC_FILE_MAP;
+	new_dyn_vec->fd = fd;
+
+	return (new_dyn_vec);
+#else
+	(void)path;
+	(void)item_size;
+
+	return (NULL);
+#endif
+}
+
+/****************************************************************
+Writes the num of items to the header of a file-backed vec and
+msyncs the header and the items to the file.
+Does nothing for a vec that is not file-backed.
+return 0 if sucsses, and 1 if fail.
+****************************************************************/
+int DynVecFlush(dyn_vec_t *vec)
+{
+	assert(vec != NULL);
+
+#ifdef DYN_VEC_USE_MREMAP
+	if (DYN_VEC_FILE_MAP == vec->storage)
+	{
+		struct dyn_vec_file_header *header = DynVecFileHeader(vec);
+
+		header->count = DynVecSize(vec);
+		if (0 != msync(header, DYN_VEC_FILE_HEADER_SIZE + 
+							   header->count * vec->item_size, MS_SYNC))
+		{
+			return (1);
+		}
+	}
+#endif
+
+	return (0);
+}
@@ -4,13 +4,54 @@
 
 typedef struct dyn_vec dyn_vec_t;
 
+#define DYN_VEC_DEFAULT_GROWTH_PERCENT (200)
+
+/* the capacity that follows capacity by growth_percent, at least one item
+   more (without overflow for large capacities). Shared with
+   dyn_vec_typed.h */
+#define DYN_VEC_GROWN_CAPACITY(capacity, growth_percent)					\
+	((((capacity) / 100 * (growth_percent)) +								\
+	  ((capacity) % 100 * (growth_percent) / 100) > (capacity)) ?			\
+	 (((capacity) / 100 * (growth_percent)) +								\
+	  ((capacity) % 100 * (growth_percent) / 100)) : ((capacity) + 1))
+
 dyn_vec_t *DynVecCreate(size_t item_size, size_t num_items);
 void DynVecDestroy(dyn_vec_t *vec);
 size_t DynVecSize(const dyn_vec_t *vec);
+size_t DynVecItemSize(const dyn_vec_t *vec);
 int DynVecPushBack(dyn_vec_t *vec, const void *item);
 void DynVecPopBack(dyn_vec_t *vec);
 void *DynVecGetItemAddress(const dyn_vec_t *vec, size_t index);
 size_t DynVecCapacity(const dyn_vec_t *vec);
 int DynVecReserve(dyn_vec_t *vec, size_t new_capacity);
 
+/* growth_percent > 100: 150 grows by 1.5x, the default 200 doubles */
+void DynVecSetGrowthFactor(dyn_vec_t *vec, size_t growth_percent);
+
+/* PopBack halves the capacity when size <= capacity / divisor.
+   0 disables it (the default) */
+void DynVecSetShrinkThreshold(dyn_vec_t *vec, size_t divisor);
+
+/* return 0 if sucsses, and 1 if fail */
+int DynVecShrinkToFit(dyn_vec_t *vec);
+
+/* Bulk operations - items must not point into the vec.
+   return 0 if sucsses, and 1 if fail (the vec is unchanged) */
+int DynVecPushBackN(dyn_vec_t *vec, const void *items, size_t n);
+int DynVecInsertRange(dyn_vec_t *vec, size_t index, const void *items, size_t n);
+void DynVecEraseRange(dyn_vec_t *vec, size_t index, size_t n);
+
+/* new items are zeroed. return 0 if sucsses, and 1 if fail */
+int DynVecResize(dyn_vec_t *vec, size_t new_size);
+void DynVecClear(dyn_vec_t *vec);
+
+/* File-backed vec: opens (or creates empty) the file at path and maps it.
+   DynVecDestroy unmaps it and closes the file.
+   return NULL if fail, or if the file holds items of another size */
+dyn_vec_t *DynVecOpenMapped(const char *path, size_t item_size);
+
+/* writes the size to the file header and msyncs.
+   return 0 if sucsses, and 1 if fail */
+int DynVecFlush(dyn_vec_t *vec);
+
 #endif /* DYN_VEC_H */
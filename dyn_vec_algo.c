@@ -0,0 +1,733 @@
+#include <stddef.h> /* for size_t */
+#include <stdint.h> /* for uint64_t */
+#include <stdlib.h> /* for malloc */
+#include <string.h> /* for memcpy */
+#include <assert.h> /* for assert */
+#include <pthread.h> /* for pthread_create */
+#include <unistd.h> /* for sysconf */
+
+#include "dyn_vec_algo.h"
+
+#define DYN_VEC_ALGO_MAX_THREADS (64)
+#define DYN_VEC_ALGO_MAX_TASKS (DYN_VEC_ALGO_MAX_THREADS * 2)
+#define DYN_VEC_ALGO_MIN_CHUNK (16384) /* min items per thread */
+#define DYN_VEC_ALGO_INSERTION_RUN (16)
+
+#define DYN_VEC_ALGO_MIN(a, b) (((a) < (b)) ? (a) : (b))
+
+typedef void *(*task_func_t)(void *task);
+
+typedef struct sort_ctx
+{
+	size_t item_size;
+	void *params;
+	int (*is_before)(const void *data1, const void *data2, void *params);
+} sort_ctx_t;
+
+typedef struct sort_task
+{
+	const sort_ctx_t *ctx;
+	char *base;
+	char *tmp;
+	size_t num_items;
+} sort_task_t;
+
+typedef struct merge_task
+{
+	const sort_ctx_t *ctx;
+	const char *a;
+	size_t num_a;
+	const char *b;
+	size_t num_b;
+	char *out;
+} merge_task_t;
+
+typedef struct for_each_task
+{
+	char *base;
+	size_t num_items;
+	size_t item_size;
+	void *params;
+	int (*do_func)(void *item, void *params);
+	int res;
+} for_each_task_t;
+
+typedef struct reduce_task
+{
+	const char *base;
+	size_t num_items;
+	size_t item_size;
+	void *acc;
+	void *params;
+	void (*accumulate)(void *acc, const void *item, void *params);
+} reduce_task_t;
+
+/****************************************************************
+Helper function - how many threads to split num_items across:
+one per online cpu, but at least DYN_VEC_ALGO_MIN_CHUNK items each
+****************************************************************/
+static size_t NumThreads(size_t num_items)
+{
+	long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+	size_t res = (cpus > 0) ? (size_t)cpus : 1;
+
+	res = DYN_VEC_ALGO_MIN(res, DYN_VEC_ALGO_MAX_THREADS);
+	res = DYN_VEC_ALGO_MIN(res, num_items / DYN_VEC_ALGO_MIN_CHUNK);
+
+	return ((res > 0) ? res : 1);
+}
+
+/****************************************************************
+Helper function - runs func on every task, each on its own thread.
+The calling thread runs the first task, and a task whose thread
+failed to start also runs on the calling thread.
+****************************************************************/
+static void RunTasks(void *tasks, size_t task_size, size_t num_tasks,
+					 task_func_t func)
+{
+	pthread_t threads[DYN_VEC_ALGO_MAX_TASKS];
+	int is_started[DYN_VEC_ALGO_MAX_TASKS];
+	char *task = (char *)tasks;
+	size_t i = 0;
+
+	assert(num_tasks <= DYN_VEC_ALGO_MAX_TASKS);
+
+	for (i = 1; i < num_tasks; ++i)
+	{
+		is_started[i] = (0 == pthread_create(&threads[i], NULL, func,
+											 task + (i * task_size)));
+	}
+
+	if (num_tasks > 0)
+	{
+		func(task);
+	}
+
+	for (i = 1; i < num_tasks; ++i)
+	{
+		if (is_started[i])
+		{
+			pthread_join(threads[i], NULL);
+		}
+		else
+		{
+			func(task + (i * task_size));
+		}
+	}
+}
+
+/****************************************************************
+Helper function - stable insertion sort of a short run.
+hold is room for one item.
+****************************************************************/
+static void InsertionSort(const sort_ctx_t *ctx, char *base,
+						  size_t num_items, char *hold)
+{
+	size_t size = ctx->item_size;
+	size_t i = 0;
+
+	for (i = 1; i < num_items; ++i)
+	{
+		size_t j = i;
+
+		if (0 == ctx->is_before(base + (i * size), base + ((i - 1) * size),
+								ctx->params))
+		{
+			continue;
+		}
+
+		memcpy(hold, base + (i * size), size);
+		while ((j > 0) &&
+			   (1 == ctx->is_before(hold, base + ((j - 1) * size),
+			   						ctx->params)))
+		{
+			--j;
+		}
+
+		memmove(base + ((j + 1) * size), base + (j * size), (i - j) * size);
+		memcpy(base + (j * size), hold, size);
+	}
+}
+
+/****************************************************************
+Helper function - merges the sorted runs a and b into out.
+On equal items, the item of a comes first.
+****************************************************************/
+static void MergeRuns(const sort_ctx_t *ctx,
+					  const char *a, size_t num_a,
+					  const char *b, size_t num_b,
+					  char *out)
+{
+	size_t size = ctx->item_size;
+
+	while ((num_a > 0) && (num_b > 0))
+	{
+		if (1 == ctx->is_before(b, a, ctx->params))
+		{
+			memcpy(out, b, size);
+			b += size;
+			--num_b;
+		}
+		else
+		{
+			memcpy(out, a, size);
+			a += size;
+			--num_a;
+		}
+		out += size;
+	}
+
+	memcpy(out, a, num_a * size);
+	out += num_a * size;
+	memcpy(out, b, num_b * size);
+}
+
+/****************************************************************
+Helper function - sorts one chunk in place.
+Insertion sort of short runs, then bottom-up merge passes
+between base and tmp.
+****************************************************************/
+static void *SortChunkTask(void *arg)
+{
+	sort_task_t *task = (sort_task_t *)arg;
+	const sort_ctx_t *ctx = task->ctx;
+	size_t size = ctx->item_size;
+	size_t n = task->num_items;
+	char *src = task->base;
+	char *dst = task->tmp;
+	size_t width = 0;
+	size_t lo = 0;
+
+	for (lo = 0; lo < n; lo += DYN_VEC_ALGO_INSERTION_RUN)
+	{
+		InsertionSort(ctx, src + (lo * size),
+					  DYN_VEC_ALGO_MIN(DYN_VEC_ALGO_INSERTION_RUN, n - lo),
+					  dst);
+	}
+
+	for (width = DYN_VEC_ALGO_INSERTION_RUN; width < n; width *= 2)
+	{
+		char *swap = NULL;
+
+		for (lo = 0; lo < n; lo += 2 * width)
+		{
+			size_t mid = DYN_VEC_ALGO_MIN(lo + width, n);
+			size_t hi = DYN_VEC_ALGO_MIN(lo + (2 * width), n);
+
+			MergeRuns(ctx, src + (lo * size), mid - lo,
+					  src + (mid * size), hi - mid, dst + (lo * size));
+		}
+
+		swap = src;
+		src = dst;
+		dst = swap;
+	}
+
+	if (src != task->base)
+	{
+		memcpy(task->base, src, n * size);
+	}
+
+	return (NULL);
+}
+
+static void *MergeTask(void *arg)
+{
+	merge_task_t *task = (merge_task_t *)arg;
+
+	MergeRuns(task->ctx, task->a, task->num_a, task->b, task->num_b,
+			  task->out);
+
+	return (NULL);
+}
+
+/****************************************************************
+Helper function - co-rank for a parallel merge:
+return i such that merging a[0, i) and b[0, k - i) gives exactly
+the first k items of merging a and b (with the order of MergeRuns).
+Time complexity: O(log(num_a + num_b)).
+****************************************************************/
+static size_t CoRank(const sort_ctx_t *ctx, size_t k,
+					 const char *a, size_t num_a,
+					 const char *b, size_t num_b)
+{
+	size_t size = ctx->item_size;
+	size_t i = DYN_VEC_ALGO_MIN(k, num_a);
+	size_t j = k - i;
+	size_t i_low = (k > num_b) ? (k - num_b) : 0;
+	size_t j_low = (k > num_a) ? (k - num_a) : 0;
+
+	for (;;)
+	{
+		/* a[i - 1] goes after b[j] - take less of a */
+		if ((i > 0) && (j < num_b) &&
+			(1 == ctx->is_before(b + (j * size), a + ((i - 1) * size),
+								 ctx->params)))
+		{
+			size_t delta = (i - i_low + 1) / 2;
+
+			j_low = j;
+			i -= delta;
+			j += delta;
+		}
+		/* b[j - 1] doesn't go before a[i] - take more of a */
+		else if ((j > 0) && (i < num_a) &&
+				 (0 == ctx->is_before(b + ((j - 1) * size), a + (i * size),
+				 					  ctx->params)))
+		{
+			size_t delta = (j - j_low + 1) / 2;
+
+			i_low = i;
+			i += delta;
+			j -= delta;
+		}
+		else
+		{
+			return (i);
+		}
+	}
+}
+
+/****************************************************************
+Sorts the items of the vec by is_before (stable merge sort).
+Each thread sorts a chunk, then the chunks are merged pairwise.
+Every merge is split by co-rank, so all threads work on each pass.
+return 0 if sucsses, and 1 if fail.
+Time complexity: O(n log n), O(n) extra memory.
+****************************************************************/
+int DynVecSort(dyn_vec_t *vec, void *params,
+			   int (*is_before)(const void *data1,
+			   					const void *data2,
+			   					void *params))
+{
+	sort_task_t sort_tasks[DYN_VEC_ALGO_MAX_THREADS];
+	merge_task_t merge_tasks[DYN_VEC_ALGO_MAX_TASKS];
+	size_t bounds[DYN_VEC_ALGO_MAX_THREADS + 1];
+	sort_ctx_t ctx = {0};
+	size_t n = 0;
+	size_t size = 0;
+	size_t num_threads = 0;
+	size_t num_runs = 0;
+	size_t t = 0;
+	char *base = NULL;
+	char *tmp = NULL;
+	char *src = NULL;
+	char *dst = NULL;
+
+	assert(vec != NULL);
+	assert(is_before != NULL);
+
+	n = DynVecSize(vec);
+	if (n < 2)
+	{
+		return (0);
+	}
+
+	size = DynVecItemSize(vec);
+	base = (char *)DynVecGetItemAddress(vec, 0);
+	tmp = (char *)malloc(n * size);
+	if (NULL == tmp)
+	{
+		return (1);
+	}
+
+	ctx.item_size = size;
+	ctx.params = params;
+	ctx.is_before = is_before;
+
+	/* sort every chunk on its own thread */
+	num_threads = NumThreads(n);
+	for (t = 0; t < num_threads; ++t)
+	{
+		bounds[t] = n * t / num_threads;
+	}
+	bounds[num_threads] = n;
+
+	for (t = 0; t < num_threads; ++t)
+	{
+		sort_tasks[t].ctx = &ctx;
+		sort_tasks[t].base = base + (bounds[t] * size);
+		sort_tasks[t].tmp = tmp + (bounds[t] * size);
+		sort_tasks[t].num_items = bounds[t + 1] - bounds[t];
+	}
+	RunTasks(sort_tasks, sizeof(*sort_tasks), num_threads, SortChunkTask);
+
+	/* merge pairs of runs, until one run is left */
+	src = base;
+	dst = tmp;
+	for (num_runs = num_threads; num_runs > 1; num_runs = (num_runs + 1) / 2)
+	{
+		size_t num_tasks = 0;
+		size_t r = 0;
+		char *swap = NULL;
+
+		for (r = 0; r < num_runs; r += 2)
+		{
+			const char *a = src + (bounds[r] * size);
+			size_t num_a = bounds[r + 1] - bounds[r];
+			const char *b = src + (bounds[r + 1] * size);
+			size_t num_b = (r + 1 < num_runs) ?
+						   (bounds[r + 2] - bounds[r + 1]) : 0;
+			size_t total = num_a + num_b;
+			size_t pieces = num_threads * total / n;
+			size_t p = 0;
+
+			pieces = (pieces > 0) ? pieces : 1;
+			for (p = 0; p < pieces; ++p)
+			{
+				size_t k0 = total * p / pieces;
+				size_t k1 = total * (p + 1) / pieces;
+				size_t i0 = CoRank(&ctx, k0, a, num_a, b, num_b);
+				size_t i1 = CoRank(&ctx, k1, a, num_a, b, num_b);
+				merge_task_t *task = &merge_tasks[num_tasks];
+
+				task->ctx = &ctx;
+				task->a = a + (i0 * size);
+				task->num_a = i1 - i0;
+				task->b = b + ((k0 - i0) * size);
+				task->num_b = (k1 - i1) - (k0 - i0);
+				task->out = dst + ((bounds[r] + k0) * size);
+				++num_tasks;
+			}
+		}
+		RunTasks(merge_tasks, sizeof(*merge_tasks), num_tasks, MergeTask);
+
+		for (r = 0; 2 * r < num_runs; ++r)
+		{
+			bounds[r] = bounds[2 * r];
+		}
+		bounds[r] = n;
+
+		swap = src;
+		src = dst;
+		dst = swap;
+	}
+
+	if (src != base)
+	{
+		memcpy(base, src, n * size);
+	}
+
+	free(tmp); tmp = NULL;
+
+	return (0);
+}
+
+/****************************************************************
+Helper function - reads an unsigned key of key_size bytes
+****************************************************************/
+static uint64_t ReadKey(const char *item, size_t key_size)
+{
+	uint8_t key8 = 0;
+	uint16_t key16 = 0;
+	uint32_t key32 = 0;
+	uint64_t key64 = 0;
+
+	switch (key_size)
+	{
+		case 1:
+			memcpy(&key8, item, 1);
+			return (key8);
+		case 2:
+			memcpy(&key16, item, 2);
+			return (key16);
+		case 4:
+			memcpy(&key32, item, 4);
+			return (key32);
+		default:
+			memcpy(&key64, item, sizeof(key64));
+			return (key64);
+	}
+}
+
+/****************************************************************
+Sorts the items by an unsigned key inside each item
+(LSD radix sort, one byte per pass). Passes in which all the
+items have the same byte are skipped.
+return 0 if sucsses, and 1 if fail.
+Time complexity: O(n * key_size), O(n) extra memory.
+****************************************************************/
+int DynVecRadixSort(dyn_vec_t *vec, size_t key_offset, size_t key_size)
+{
+	size_t n = 0;
+	size_t size = 0;
+	size_t shift = 0;
+	char *base = NULL;
+	char *src = NULL;
+	char *dst = NULL;
+
+	assert(vec != NULL);
+	assert((1 == key_size) || (2 == key_size) || (4 == key_size) ||
+		   (8 == key_size));
+	assert(key_offset + key_size <= DynVecItemSize(vec));
+
+	n = DynVecSize(vec);
+	if (n < 2)
+	{
+		return (0);
+	}
+
+	size = DynVecItemSize(vec);
+	base = (char *)DynVecGetItemAddress(vec, 0);
+	dst = (char *)malloc(n * size);
+	if (NULL == dst)
+	{
+		return (1);
+	}
+	src = base;
+
+	for (shift = 0; shift < key_size * 8; shift += 8)
+	{
+		size_t count[256] = {0};
+		size_t offset = 0;
+		size_t i = 0;
+		char *swap = NULL;
+
+		for (i = 0; i < n; ++i)
+		{
+			++count[(ReadKey(src + (i * size) + key_offset, key_size) >>
+					shift) & 0xFF];
+		}
+
+		/* all the items have the same byte - nothing to move */
+		if (n == count[(ReadKey(src + key_offset, key_size) >> shift) & 0xFF])
+		{
+			continue;
+		}
+
+		for (i = 0; i < 256; ++i)
+		{
+			size_t tmp = count[i];
+
+			count[i] = offset;
+			offset += tmp;
+		}
+
+		for (i = 0; i < n; ++i)
+		{
+			const char *item = src + (i * size);
+			size_t bucket = (ReadKey(item + key_offset, key_size) >> shift) &
+							0xFF;
+
+			memcpy(dst + (count[bucket] * size), item, size);
+			++count[bucket];
+		}
+
+		swap = src;
+		src = dst;
+		dst = swap;
+	}
+
+	if (src != base)
+	{
+		memcpy(base, src, n * size);
+		dst = src;
+	}
+
+	free(dst); dst = NULL;
+
+	return (0);
+}
+
+/****************************************************************
+Binary search for the first item that is not before to_find.
+Time complexity: O(log n).
+****************************************************************/
+size_t DynVecLowerBound(const dyn_vec_t *vec, const void *to_find,
+						void *params,
+						int (*is_before)(const void *data1,
+										 const void *data2,
+										 void *params))
+{
+	size_t lo = 0;
+	size_t hi = 0;
+	size_t size = 0;
+	const char *base = NULL;
+
+	assert(vec != NULL);
+	assert(is_before != NULL);
+
+	hi = DynVecSize(vec);
+	size = DynVecItemSize(vec);
+	base = (const char *)DynVecGetItemAddress(vec, 0);
+
+	while (lo < hi)
+	{
+		size_t mid = lo + ((hi - lo) / 2);
+
+		if (1 == is_before(base + (mid * size), to_find, params))
+		{
+			lo = mid + 1;
+		}
+		else
+		{
+			hi = mid;
+		}
+	}
+
+	return (lo);
+}
+
+/****************************************************************
+return the address of the first item equal to to_find
+(neither is before the other), or NULL.
+Time complexity: O(log n).
+****************************************************************/
+void *DynVecBinarySearch(const dyn_vec_t *vec, const void *to_find,
+						 void *params,
+						 int (*is_before)(const void *data1,
+						 				  const void *data2,
+						 				  void *params))
+{
+	size_t index = DynVecLowerBound(vec, to_find, params, is_before);
+	void *item = NULL;
+
+	if (index == DynVecSize(vec))
+	{
+		return (NULL);
+	}
+
+	item = DynVecGetItemAddress(vec, index);
+
+	return ((0 == is_before(to_find, item, params)) ? item : NULL);
+}
+
+static void *ForEachTask(void *arg)
+{
+	for_each_task_t *task = (for_each_task_t *)arg;
+	size_t i = 0;
+
+	for (i = 0; (i < task->num_items) && (0 == task->res); ++i)
+	{
+		task->res = task->do_func(task->base + (i * task->item_size),
+								  task->params);
+	}
+
+	return (NULL);
+}
+
+/****************************************************************
+Operates do_func on every item, the items are split in chunks
+across threads.
+return 0, or the non-zero value of the first chunk that stopped.
+Time complexity: O(n / num of threads).
+****************************************************************/
+int DynVecForEach(dyn_vec_t *vec, void *params,
+				  int (*do_func)(void *item, void *params))
+{
+	for_each_task_t tasks[DYN_VEC_ALGO_MAX_THREADS];
+	size_t n = 0;
+	size_t size = 0;
+	size_t num_threads = 0;
+	size_t t = 0;
+	char *base = NULL;
+
+	assert(vec != NULL);
+	assert(do_func != NULL);
+
+	n = DynVecSize(vec);
+	size = DynVecItemSize(vec);
+	base = (char *)DynVecGetItemAddress(vec, 0);
+	num_threads = NumThreads(n);
+
+	for (t = 0; t < num_threads; ++t)
+	{
+		size_t lo = n * t / num_threads;
+		size_t hi = n * (t + 1) / num_threads;
+
+		tasks[t].base = base + (lo * size);
+		tasks[t].num_items = hi - lo;
+		tasks[t].item_size = size;
+		tasks[t].params = params;
+		tasks[t].do_func = do_func;
+		tasks[t].res = 0;
+	}
+	RunTasks(tasks, sizeof(*tasks), num_threads, ForEachTask);
+
+	for (t = 0; t < num_threads; ++t)
+	{
+		if (tasks[t].res != 0)
+		{
+			return (tasks[t].res);
+		}
+	}
+
+	return (0);
+}
+
+static void *ReduceTask(void *arg)
+{
+	reduce_task_t *task = (reduce_task_t *)arg;
+	size_t i = 0;
+
+	for (i = 0; i < task->num_items; ++i)
+	{
+		task->accumulate(task->acc, task->base + (i * task->item_size),
+						 task->params);
+	}
+
+	return (NULL);
+}
+
+/****************************************************************
+Reduces the items into acc: every thread accumulates a chunk
+into a copy of the identity in acc, and the copies are combined
+into acc in index order (so combine needs to be associative only).
+return 0 if sucsses, and 1 if fail.
+Time complexity: O(n / num of threads).
+****************************************************************/
+int DynVecReduce(const dyn_vec_t *vec, void *acc, size_t acc_size,
+				 void *params,
+				 void (*accumulate)(void *acc, const void *item,
+				 					void *params),
+				 void (*combine)(void *acc, const void *other_acc,
+				 				 void *params))
+{
+	reduce_task_t tasks[DYN_VEC_ALGO_MAX_THREADS];
+	size_t n = 0;
+	size_t size = 0;
+	size_t num_threads = 0;
+	size_t t = 0;
+	const char *base = NULL;
+	char *accs = NULL;
+
+	assert(vec != NULL);
+	assert(acc != NULL);
+	assert(accumulate != NULL);
+	assert(combine != NULL);
+
+	n = DynVecSize(vec);
+	size = DynVecItemSize(vec);
+	base = (const char *)DynVecGetItemAddress(vec, 0);
+	num_threads = NumThreads(n);
+
+	accs = (char *)malloc(num_threads * acc_size);
+	if (NULL == accs)
+	{
+		return (1);
+	}
+
+	for (t = 0; t < num_threads; ++t)
+	{
+		size_t lo = n * t / num_threads;
+		size_t hi = n * (t + 1) / num_threads;
+
+		memcpy(accs + (t * acc_size), acc, acc_size);
+		tasks[t].base = base + (lo * size);
+		tasks[t].num_items = hi - lo;
+		tasks[t].item_size = size;
+		tasks[t].acc = accs + (t * acc_size);
+		tasks[t].params = params;
+		tasks[t].accumulate = accumulate;
+	}
+	RunTasks(tasks, sizeof(*tasks), num_threads, ReduceTask);
+
+	for (t = 0; t < num_threads; ++t)
+	{
+		combine(acc, accs + (t * acc_size), params);
+	}
+
+	free(accs); accs = NULL;
+
+	return (0);
+}
@@ -0,0 +1,45 @@
+#ifndef DYN_VEC_ALGO_H
+#define DYN_VEC_ALGO_H
+#include <stddef.h> /* size_t */
+
+#include "dyn_vec.h"
+
+/* Algorithms over the items of a dyn_vec.
+   Large vecs are split across threads (one per online cpu) */
+
+/* is_before returns 1 if data1 must come before data2.
+   Stable sort. return 0 if sucsses, and 1 if fail (the vec is unchanged) */
+int DynVecSort(dyn_vec_t *vec, void *params,
+			   int (*is_before)(const void *data1, const void *data2, void *params));
+
+/* Stable sort by an unsigned integer key of key_size bytes (1, 2, 4 or 8)
+   at key_offset inside each item, in native byte order.
+   return 0 if sucsses, and 1 if fail (the vec is unchanged) */
+int DynVecRadixSort(dyn_vec_t *vec, size_t key_offset, size_t key_size);
+
+/* The vec must be sorted by is_before.
+   return the index of the first item that is not before to_find,
+   or DynVecSize if there is no such item */
+size_t DynVecLowerBound(const dyn_vec_t *vec, const void *to_find, void *params,
+						int (*is_before)(const void *data1, const void *data2, void *params));
+
+/* The vec must be sorted by is_before.
+   return the address of the first item equal to to_find, or NULL */
+void *DynVecBinarySearch(const dyn_vec_t *vec, const void *to_find, void *params,
+						int (*is_before)(const void *data1, const void *data2, void *params));
+
+/* do_func runs on every item, concurrently on different items.
+   A non-zero value stops the chunk of items it was returned in,
+   and the value of the first such chunk is returned */
+int DynVecForEach(dyn_vec_t *vec, void *params,
+				  int (*do_func)(void *item, void *params));
+
+/* acc holds the identity value on call and the result on return.
+   Every thread accumulates its chunk into its own copy of the identity,
+   then the copies are combined into acc in index order.
+   return 0 if sucsses, and 1 if fail */
+int DynVecReduce(const dyn_vec_t *vec, void *acc, size_t acc_size, void *params,
+				 void (*accumulate)(void *acc, const void *item, void *params),
+				 void (*combine)(void *acc, const void *other_acc, void *params));
+
+#endif /* DYN_VEC_ALGO_H */
@@ -0,0 +1,589 @@
+#include <stddef.h> /* for size_t */
+#include <stdint.h> /* for int32_t */
+#include <assert.h> /* for assert */
+#include <pthread.h> /* for pthread_once */
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define DYN_VEC_SIMD_X86
+#include <immintrin.h> /* for AVX2 intrinsics */
+#endif
+
+#include "dyn_vec_simd.h"
+
+typedef struct simd_kernels
+{
+	size_t (*find_i32)(const int32_t *items, size_t n, int32_t value);
+	size_t (*find_f32)(const float *items, size_t n, float value);
+	size_t (*find_f64)(const double *items, size_t n, double value);
+
+	size_t (*count_i32)(const int32_t *items, size_t n, int32_t value);
+	size_t (*count_f32)(const float *items, size_t n, float value);
+	size_t (*count_f64)(const double *items, size_t n, double value);
+
+	void (*min_max_i32)(const int32_t *items, size_t n, int32_t *min, int32_t *max);
+	void (*min_max_f32)(const float *items, size_t n, float *min, float *max);
+	void (*min_max_f64)(const double *items, size_t n, double *min, double *max);
+
+	int64_t (*sum_i32)(const int32_t *items, size_t n);
+	double (*sum_f32)(const float *items, size_t n);
+	double (*sum_f64)(const double *items, size_t n);
+
+	size_t (*greater_i32)(const int32_t *items, size_t n, int32_t threshold, int32_t *out);
+	size_t (*greater_f32)(const float *items, size_t n, float threshold, float *out);
+	size_t (*greater_f64)(const double *items, size_t n, double threshold, double *out);
+} simd_kernels_t;
+
+/****************************************************************
+Scalar kernels, one set per item type.
+Also used for the tails of the AVX2 kernels.
+****************************************************************/
+#define DYN_VEC_SIMD_SCALAR_KERNELS(kind, type, sum_type)					\
+																			\
+static size_t ScalarFind_##kind(const type *items, size_t n, type value)	\
+{																			\
+	size_t i = 0;															\
+																			\
+	while ((i < n) && !(items[i] == value))									\
+	{																		\
+		++i;																\
+	}																		\
+																			\
+	return (i);																\
+}																			\
+																			\
+static size_t ScalarCount_##kind(const type *items, size_t n, type value)	\
+{																			\
+	size_t res = 0;															\
+	size_t i = 0;															\
+																			\
+	for (i = 0; i < n; ++i)													\
+	{																		\
+		res += (items[i] == value);											\
+	}																		\
+																			\
+	return (res);															\
+}																			\
+																			\
+static void ScalarMinMax_##kind(const type *items, size_t n,				\
+								type *min, type *max)						\
+{																			\
+	size_t i = 0;															\
+																			\
+	for (i = 0; i < n; ++i)													\
+	{																		\
+		*min = (items[i] < *min) ? items[i] : *min;							\
+		*max = (items[i] > *max) ? items[i] : *max;							\
+	}																		\
+}																			\
+																			\
+static sum_type ScalarSum_##kind(const type *items, size_t n)				\
+{																			\
+	sum_type res = 0;														\
+	size_t i = 0;															\
+																			\
+	for (i = 0; i < n; ++i)													\
+	{																		\
+		res += items[i];													\
+	}																		\
+																			\
+	return (res);															\
+}																			\
+																			\
+static size_t ScalarGreater_##kind(const type *items, size_t n,				\
+								   type threshold, type *out)				\
+{																			\
+	size_t res = 0;															\
+	size_t i = 0;															\
+																			\
+	for (i = 0; i < n; ++i)													\
+	{																		\
+		out[res] = items[i];												\
+		res += (items[i] > threshold);										\
+	}																		\
+																			\
+	return (res);															\
+}
+
+DYN_VEC_SIMD_SCALAR_KERNELS(i32, int32_t, int64_t)
+DYN_VEC_SIMD_SCALAR_KERNELS(f32, float, double)
+DYN_VEC_SIMD_SCALAR_KERNELS(f64, double, double)
+
+#ifdef DYN_VEC_SIMD_X86
+
+#define DYN_VEC_AVX2 __attribute__((target("avx2")))
+
+/****************************************************************
+Helper function - appends the items of a block whose bits are
+set in mask to out, in order. return the num appended.
+****************************************************************/
+#define DYN_VEC_SIMD_APPEND_MASKED(type)									\
+static size_t AppendMasked_##type(const type *block, unsigned int mask,		\
+								  type *out)								\
+{																			\
+	size_t res = 0;															\
+																			\
+	while (mask != 0)														\
+	{																		\
+		out[res] = block[__builtin_ctz(mask)];								\
+		++res;																\
+		mask &= mask - 1;													\
+	}																		\
+																			\
+	return (res);															\
+}
+
+DYN_VEC_SIMD_APPEND_MASKED(int32_t)
+DYN_VEC_SIMD_APPEND_MASKED(float)
+DYN_VEC_SIMD_APPEND_MASKED(double)
+
+/* int32_t - 8 lanes */
+
+DYN_VEC_AVX2 static size_t Avx2Find_i32(const int32_t *items, size_t n,
+										int32_t value)
+{
+	__m256i key = _mm256_set1_epi32(value);
+	size_t i = 0;
+
+	for (i = 0; i + 8 <= n; i += 8)
+	{
+		__m256i eq = _mm256_cmpeq_epi32(
+						_mm256_loadu_si256((const __m256i *)(items + i)), key);
+		unsigned int mask = _mm256_movemask_ps(_mm256_castsi256_ps(eq));
+
+		if (mask != 0)
+		{
+			return (i + __builtin_ctz(mask));
+		}
+	}
+
+	return (i + ScalarFind_i32(items + i, n - i, value));
+}
+
+DYN_VEC_AVX2 static size_t Avx2Count_i32(const int32_t *items, size_t n,
+										 int32_t value)
+{
+	__m256i key = _mm256_set1_epi32(value);
+	size_t res = 0;
+	size_t i = 0;
+
+	for (i = 0; i + 8 <= n; i += 8)
+	{
+		__m256i eq = _mm256_cmpeq_epi32(
+						_mm256_loadu_si256((const __m256i *)(items + i)), key);
+
+		res += __builtin_popcount(_mm256_movemask_ps(_mm256_castsi256_ps(eq)));
+	}
+
+	return (res + ScalarCount_i32(items + i, n - i, value));
+}
+
+DYN_VEC_AVX2 static void Avx2MinMax_i32(const int32_t *items, size_t n,
+										int32_t *min, int32_t *max)
+{
+	__m256i vmin = _mm256_set1_epi32(*min);
+	__m256i vmax = _mm256_set1_epi32(*max);
+	int32_t lanes[8];
+	size_t i = 0;
+
+	for (i = 0; i + 8 <= n; i += 8)
+	{
+		__m256i v = _mm256_loadu_si256((const __m256i *)(items + i));
+
+		vmin = _mm256_min_epi32(vmin, v);
+		vmax = _mm256_max_epi32(vmax, v);
+	}
+
+	_mm256_storeu_si256((__m256i *)lanes, vmin);
+	ScalarMinMax_i32(lanes, 8, min, max);
+	_mm256_storeu_si256((__m256i *)lanes, vmax);
+	ScalarMinMax_i32(lanes, 8, min, max);
+	ScalarMinMax_i32(items + i, n - i, min, max);
+}
+
+DYN_VEC_AVX2 static int64_t Avx2Sum_i32(const int32_t *items, size_t n)
+{
+	__m256i acc = _mm256_setzero_si256();
+	int64_t lanes[4];
+	size_t i = 0;
+
+	for (i = 0; i + 8 <= n; i += 8)
+	{
+		__m256i v = _mm256_loadu_si256((const __m256i *)(items + i));
+
+		acc = _mm256_add_epi64(acc, _mm256_cvtepi32_epi64(
+										_mm256_castsi256_si128(v)));
+		acc = _mm256_add_epi64(acc, _mm256_cvtepi32_epi64(
+										_mm256_extracti128_si256(v, 1)));
+	}
+
+	_mm256_storeu_si256((__m256i *)lanes, acc);
+
+	return (lanes[0] + lanes[1] + lanes[2] + lanes[3] +
+			ScalarSum_i32(items + i, n - i));
+}
+
+DYN_VEC_AVX2 static size_t Avx2Greater_i32(const int32_t *items, size_t n,
+										   int32_t threshold, int32_t *out)
+{
+	__m256i key = _mm256_set1_epi32(threshold);
+	size_t res = 0;
+	size_t i = 0;
+
+	for (i = 0; i + 8 <= n; i += 8)
+	{
+		__m256i gt = _mm256_cmpgt_epi32(
+						_mm256_loadu_si256((const __m256i *)(items + i)), key);
+
+		res += AppendMasked_int32_t(items + i,
+							_mm256_movemask_ps(_mm256_castsi256_ps(gt)),
+							out + res);
+	}
+
+	return (res + ScalarGreater_i32(items + i, n - i, threshold, out + res));
+}
+
+/* float - 8 lanes */
+
+DYN_VEC_AVX2 static size_t Avx2Find_f32(const float *items, size_t n,
+										float value)
+{
+	__m256 key = _mm256_set1_ps(value);
+	size_t i = 0;
+
+	for (i = 0; i + 8 <= n; i += 8)
+	{
+		unsigned int mask = _mm256_movemask_ps(
+				_mm256_cmp_ps(_mm256_loadu_ps(items + i), key, _CMP_EQ_OQ));
+
+		if (mask != 0)
+		{
+			return (i + __builtin_ctz(mask));
+		}
+	}
+
+	return (i + ScalarFind_f32(items + i, n - i, value));
+}
+
+DYN_VEC_AVX2 static size_t Avx2Count_f32(const float *items, size_t n,
+										 float value)
+{
+	__m256 key = _mm256_set1_ps(value);
+	size_t res = 0;
+	size_t i = 0;
+
+	for (i = 0; i + 8 <= n; i += 8)
+	{
+		res += __builtin_popcount(_mm256_movemask_ps(
+				_mm256_cmp_ps(_mm256_loadu_ps(items + i), key, _CMP_EQ_OQ)));
+	}
+
+	return (res + ScalarCount_f32(items + i, n - i, value));
+}
+
+DYN_VEC_AVX2 static void Avx2MinMax_f32(const float *items, size_t n,
+										float *min, float *max)
+{
+	__m256 vmin = _mm256_set1_ps(*min);
+	__m256 vmax = _mm256_set1_ps(*max);
+	float lanes[8];
+	size_t i = 0;
+
+	for (i = 0; i + 8 <= n; i += 8)
+	{
+		__m256 v = _mm256_loadu_ps(items + i);
+
+		vmin = _mm256_min_ps(vmin, v);
+		vmax = _mm256_max_ps(vmax, v);
+	}
+
+	_mm256_storeu_ps(lanes, vmin);
+	ScalarMinMax_f32(lanes, 8, min, max);
+	_mm256_storeu_ps(lanes, vmax);
+	ScalarMinMax_f32(lanes, 8, min, max);
+	ScalarMinMax_f32(items + i, n - i, min, max);
+}
+
+DYN_VEC_AVX2 static double Avx2Sum_f32(const float *items, size_t n)
+{
+	__m256d acc = _mm256_setzero_pd();
+	double lanes[4];
+	size_t i = 0;
+
+	/* accumulate in double, like the scalar version */
+	for (i = 0; i + 8 <= n; i += 8)
+	{
+		__m256 v = _mm256_loadu_ps(items + i);
+
+		acc = _mm256_add_pd(acc, _mm256_cvtps_pd(_mm256_castps256_ps128(v)));
+		acc = _mm256_add_pd(acc, _mm256_cvtps_pd(_mm256_extractf128_ps(v, 1)));
+	}
+
+	_mm256_storeu_pd(lanes, acc);
+
+	return (lanes[0] + lanes[1] + lanes[2] + lanes[3] +
+			ScalarSum_f32(items + i, n - i));
+}
+
+DYN_VEC_AVX2 static size_t Avx2Greater_f32(const float *items, size_t n,
+										   float threshold, float *out)
+{
+	__m256 key = _mm256_set1_ps(threshold);
+	size_t res = 0;
+	size_t i = 0;
+
+	for (i = 0; i + 8 <= n; i += 8)
+	{
+		unsigned int mask = _mm256_movemask_ps(
+				_mm256_cmp_ps(_mm256_loadu_ps(items + i), key, _CMP_GT_OQ));
+
+		res += AppendMasked_float(items + i, mask, out + res);
+	}
+
+	return (res + ScalarGreater_f32(items + i, n - i, threshold, out + res));
+}
+
+/* double - 4 lanes */
+
+DYN_VEC_AVX2 static size_t Avx2Find_f64(const double *items, size_t n,
+										double value)
+{
+	__m256d key = _mm256_set1_pd(value);
+	size_t i = 0;
+
+	for (i = 0; i + 4 <= n; i += 4)
+	{
+		unsigned int mask = _mm256_movemask_pd(
+				_mm256_cmp_pd(_mm256_loadu_pd(items + i), key, _CMP_EQ_OQ));
+
+		if (mask != 0)
+		{
+			return (i + __builtin_ctz(mask));
+		}
+	}
+
+	return (i + ScalarFind_f64(items + i, n - i, value));
+}
+
+DYN_VEC_AVX2 static size_t Avx2Count_f64(const double *items, size_t n,
+										 double value)
+{
+	__m256d key = _mm256_set1_pd(value);
+	size_t res = 0;
+	size_t i = 0;
+
+	for (i = 0; i + 4 <= n; i += 4)
+	{
+		res += __builtin_popcount(_mm256_movemask_pd(
+				_mm256_cmp_pd(_mm256_loadu_pd(items + i), key, _CMP_EQ_OQ)));
+	}
+
+	return (res + ScalarCount_f64(items + i, n - i, value));
+}
+
+DYN_VEC_AVX2 static void Avx2MinMax_f64(const double *items, size_t n,
+										double *min, double *max)
+{
+	__m256d vmin = _mm256_set1_pd(*min);
+	__m256d vmax = _mm256_set1_pd(*max);
+	double lanes[4];
+	size_t i = 0;
+
+	for (i = 0; i + 4 <= n; i += 4)
+	{
+		__m256d v = _mm256_loadu_pd(items + i);
+
+		vmin = _mm256_min_pd(vmin, v);
+		vmax = _mm256_max_pd(vmax, v);
+	}
+
+	_mm256_storeu_pd(lanes, vmin);
+	ScalarMinMax_f64(lanes, 4, min, max);
+	_mm256_storeu_pd(lanes, vmax);
+	ScalarMinMax_f64(lanes, 4, min, max);
+	ScalarMinMax_f64(items + i, n - i, min, max);
+}
+
+DYN_VEC_AVX2 static double Avx2Sum_f64(const double *items, size_t n)
+{
+	__m256d acc = _mm256_setzero_pd();
+	double lanes[4];
+	size_t i = 0;
+
+	for (i = 0; i + 4 <= n; i += 4)
+	{
+		acc = _mm256_add_pd(acc, _mm256_loadu_pd(items + i));
+	}
+
+	_mm256_storeu_pd(lanes, acc);
+
+	return (lanes[0] + lanes[1] + lanes[2] + lanes[3] +
+			ScalarSum_f64(items + i, n - i));
+}
+
+DYN_VEC_AVX2 static size_t Avx2Greater_f64(const double *items, size_t n,
+										   double threshold, double *out)
+{
+	__m256d key = _mm256_set1_pd(threshold);
+	size_t res = 0;
+	size_t i = 0;
+
+	for (i = 0; i + 4 <= n; i += 4)
+	{
+		unsigned int mask = _mm256_movemask_pd(
+				_mm256_cmp_pd(_mm256_loadu_pd(items + i), key, _CMP_GT_OQ));
+
+		res += AppendMasked_double(items + i, mask, out + res);
+	}
+
+	return (res + ScalarGreater_f64(items + i, n - i, threshold, out + res));
+}
+
+#endif /* DYN_VEC_SIMD_X86 */
+
+static simd_kernels_t g_kernels;
+static pthread_once_t g_kernels_once = PTHREAD_ONCE_INIT;
+
+/****************************************************************
+Helper function - chooses the kernels by the cpu, once.
+****************************************************************/
+static void InitKernels(void)
+{
+	g_kernels.find_i32 = ScalarFind_i32;
+	g_kernels.find_f32 = ScalarFind_f32;
+	g_kernels.find_f64 = ScalarFind_f64;
+	g_kernels.count_i32 = ScalarCount_i32;
+	g_kernels.count_f32 = ScalarCount_f32;
+	g_kernels.count_f64 = ScalarCount_f64;
+	g_kernels.min_max_i32 = ScalarMinMax_i32;
+	g_kernels.min_max_f32 = ScalarMinMax_f32;
+	g_kernels.min_max_f64 = ScalarMinMax_f64;
+	g_kernels.sum_i32 = ScalarSum_i32;
+	g_kernels.sum_f32 = ScalarSum_f32;
+	g_kernels.sum_f64 = ScalarSum_f64;
+	g_kernels.greater_i32 = ScalarGreater_i32;
+	g_kernels.greater_f32 = ScalarGreater_f32;
+	g_kernels.greater_f64 = ScalarGreater_f64;
+
+#ifdef DYN_VEC_SIMD_X86
+	__builtin_cpu_init();
+	if (__builtin_cpu_supports("avx2"))
+	{
+		g_kernels.find_i32 = Avx2Find_i32;
+		g_kernels.find_f32 = Avx2Find_f32;
+		g_kernels.find_f64 = Avx2Find_f64;
+		g_kernels.count_i32 = Avx2Count_i32;
+		g_kernels.count_f32 = Avx2Count_f32;
+		g_kernels.count_f64 = Avx2Count_f64;
+		g_kernels.min_max_i32 = Avx2MinMax_i32;
+		g_kernels.min_max_f32 = Avx2MinMax_f32;
+		g_kernels.min_max_f64 = Avx2MinMax_f64;
+		g_kernels.sum_i32 = Avx2Sum_i32;
+		g_kernels.sum_f32 = Avx2Sum_f32;
+		g_kernels.sum_f64 = Avx2Sum_f64;
+		g_kernels.greater_i32 = Avx2Greater_i32;
+		g_kernels.greater_f32 = Avx2Greater_f32;
+		g_kernels.greater_f64 = Avx2Greater_f64;
+	}
+#endif
+}
+
+static const simd_kernels_t *Kernels(void)
+{
+	pthread_once(&g_kernels_once, InitKernels);
+
+	return (&g_kernels);
+}
+
+/****************************************************************
+The API, one set per item type.
+Time complexity: O(n).
+****************************************************************/
+#define DYN_VEC_SIMD_API(SUFFIX, kind, type, sum_type)						\
+																			\
+size_t DynVecFind##SUFFIX(const dyn_vec_t *vec, type value)					\
+{																			\
+	assert(vec != NULL);													\
+	assert(sizeof(type) == DynVecItemSize(vec));							\
+																			\
+	return (Kernels()->find_##kind(											\
+				(const type *)DynVecGetItemAddress(vec, 0),					\
+				DynVecSize(vec), value));									\
+}																			\
+																			\
+size_t DynVecCount##SUFFIX(const dyn_vec_t *vec, type value)				\
+{																			\
+	assert(vec != NULL);													\
+	assert(sizeof(type) == DynVecItemSize(vec));							\
+																			\
+	return (Kernels()->count_##kind(										\
+				(const type *)DynVecGetItemAddress(vec, 0),					\
+				DynVecSize(vec), value));									\
+}																			\
+																			\
+int DynVecMinMax##SUFFIX(const dyn_vec_t *vec, type *min, type *max)		\
+{																			\
+	const type *items = NULL;												\
+																			\
+	assert(vec != NULL);													\
+	assert(min != NULL);													\
+	assert(max != NULL);													\
+	assert(sizeof(type) == DynVecItemSize(vec));							\
+																			\
+	if (0 == DynVecSize(vec))												\
+	{																		\
+		return (1);															\
+	}																		\
+																			\
+	items = (const type *)DynVecGetItemAddress(vec, 0);						\
+	*min = items[0];														\
+	*max = items[0];														\
+	Kernels()->min_max_##kind(items, DynVecSize(vec), min, max);			\
+																			\
+	return (0);																\
+}																			\
+																			\
+sum_type DynVecSum##SUFFIX(const dyn_vec_t *vec)							\
+{																			\
+	assert(vec != NULL);													\
+	assert(sizeof(type) == DynVecItemSize(vec));							\
+																			\
+	return (Kernels()->sum_##kind(											\
+				(const type *)DynVecGetItemAddress(vec, 0),					\
+				DynVecSize(vec)));											\
+}																			\
+																			\
+dyn_vec_t *DynVecFilterGreater##SUFFIX(const dyn_vec_t *vec, type threshold)\
+{																			\
+	dyn_vec_t *res = NULL;													\
+	size_t size = 0;														\
+																			\
+	assert(vec != NULL);													\
+	assert(sizeof(type) == DynVecItemSize(vec));							\
+																			\
+	/* the new vec starts with room for all the items */					\
+	size = DynVecSize(vec);													\
+	res = DynVecCreate(sizeof(type), (size > 0) ? size : 1);				\
+	if (NULL == res)														\
+	{																		\
+		return (NULL);														\
+	}																		\
+																			\
+	size = Kernels()->greater_##kind(										\
+				(const type *)DynVecGetItemAddress(vec, 0), size,			\
+				threshold, (type *)DynVecGetItemAddress(res, 0));			\
+	if (0 != DynVecResize(res, size))										\
+	{																		\
+		DynVecDestroy(res); res = NULL;										\
+		return (NULL);														\
+	}																		\
+																			\
+	/* give back the room of the filtered out items (on failure				\
+	   the vec is still right, only larger) */								\
+	DynVecShrinkToFit(res);													\
+																			\
+	return (res);															\
+}
+
+DYN_VEC_SIMD_API(I32, i32, int32_t, int64_t)
+DYN_VEC_SIMD_API(F32, f32, float, double)
+DYN_VEC_SIMD_API(F64, f64, double, double)
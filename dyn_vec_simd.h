@@ -0,0 +1,39 @@
+#ifndef DYN_VEC_SIMD_H
+#define DYN_VEC_SIMD_H
+#include <stddef.h> /* size_t */
+#include <stdint.h> /* int32_t */
+
+#include "dyn_vec.h"
+
+/* Scans over dyn_vecs of int32_t / float / double items
+   (item_size must match the type). The AVX2 or the scalar version
+   is chosen by the cpu at the first call.
+   NaN items are not supported by MinMax. */
+
+/* return the index of the first item equal to value, or DynVecSize */
+size_t DynVecFindI32(const dyn_vec_t *vec, int32_t value);
+size_t DynVecFindF32(const dyn_vec_t *vec, float value);
+size_t DynVecFindF64(const dyn_vec_t *vec, double value);
+
+/* return the num of items equal to value */
+size_t DynVecCountI32(const dyn_vec_t *vec, int32_t value);
+size_t DynVecCountF32(const dyn_vec_t *vec, float value);
+size_t DynVecCountF64(const dyn_vec_t *vec, double value);
+
+/* return 0 if sucsses, and 1 if the vec is empty */
+int DynVecMinMaxI32(const dyn_vec_t *vec, int32_t *min, int32_t *max);
+int DynVecMinMaxF32(const dyn_vec_t *vec, float *min, float *max);
+int DynVecMinMaxF64(const dyn_vec_t *vec, double *min, double *max);
+
+/* the order of the additions differs from a sequential loop */
+int64_t DynVecSumI32(const dyn_vec_t *vec);
+double DynVecSumF32(const dyn_vec_t *vec);
+double DynVecSumF64(const dyn_vec_t *vec);
+
+/* return a new vec of the items greater than threshold (in order),
+   or NULL if the allocation fails */
+dyn_vec_t *DynVecFilterGreaterI32(const dyn_vec_t *vec, int32_t threshold);
+dyn_vec_t *DynVecFilterGreaterF32(const dyn_vec_t *vec, float threshold);
+dyn_vec_t *DynVecFilterGreaterF64(const dyn_vec_t *vec, double threshold);
+
+#endif /* DYN_VEC_SIMD_H */
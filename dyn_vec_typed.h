@@ -0,0 +1,168 @@
+#ifndef DYN_VEC_TYPED_H
+#define DYN_VEC_TYPED_H
+#include <stddef.h> /* size_t */
+#include <stdlib.h> /* for malloc */
+#include <assert.h> /* for assert */
+
+#include "dyn_vec.h" /* for DYN_VEC_GROWN_CAPACITY */
+
+/****************************************************************
+Typed dyn_vec, generated per item type.
+DEFINE_DYN_VEC(int32, int32_t) defines dyn_vec_int32_t and
+DynVec_int32_Create ... with the same semantics as dyn_vec.h,
+but items are passed by value and copied by assignment,
+so the compiler can inline and vectorize them.
+
+	DEFINE_DYN_VEC(int32, int32_t)
+
+	dyn_vec_int32_t *vec = DynVec_int32_Create(16);
+	DynVec_int32_PushBack(vec, 42);
+****************************************************************/
+
+#if defined(__STDC_VERSION__) && (__STDC_VERSION__ >= 199901L)
+#define DYN_VEC_INLINE inline
+#elif defined(__GNUC__)
+#define DYN_VEC_INLINE __inline__
+#else
+#define DYN_VEC_INLINE
+#endif
+
+#define DEFINE_DYN_VEC(name, type)											\
+																			\
+typedef struct dyn_vec_##name												\
+{																			\
+	type *start;															\
+	size_t size;															\
+	size_t num_items; /* capacity */										\
+	size_t growth_percent; /* as in dyn_vec.h, 200 doubles */				\
+} dyn_vec_##name##_t;														\
+																			\
+/* return pointer to dyn_vec of num_items zeroed items, or NULL */			\
+static DYN_VEC_INLINE dyn_vec_##name##_t *DynVec_##name##_Create(			\
+											size_t num_items)				\
+{																			\
+	dyn_vec_##name##_t *vec = NULL;											\
+																			\
+	assert(num_items);														\
+																			\
+	vec = (dyn_vec_##name##_t *)malloc(sizeof(*vec));						\
+	if (NULL == vec)														\
+	{																		\
+		return (NULL);														\
+	}																		\
+																			\
+	vec->start = (type *)calloc(num_items, sizeof(type));					\
+	if (NULL == vec->start)													\
+	{																		\
+		free(vec); vec = NULL;												\
+		return (NULL);														\
+	}																		\
+																			\
+	vec->size = num_items;													\
+	vec->num_items = num_items;												\
+	vec->growth_percent = DYN_VEC_DEFAULT_GROWTH_PERCENT;					\
+																			\
+	return (vec);															\
+}																			\
+																			\
+static DYN_VEC_INLINE void DynVec_##name##_Destroy(dyn_vec_##name##_t *vec)	\
+{																			\
+	assert(vec != NULL);													\
+																			\
+	free(vec->start); vec->start = NULL;									\
+	free(vec); vec = NULL;													\
+}																			\
+																			\
+static DYN_VEC_INLINE size_t DynVec_##name##_Size(							\
+										const dyn_vec_##name##_t *vec)		\
+{																			\
+	assert(vec != NULL);													\
+																			\
+	return (vec->size);														\
+}																			\
+																			\
+static DYN_VEC_INLINE size_t DynVec_##name##_Capacity(						\
+										const dyn_vec_##name##_t *vec)		\
+{																			\
+	assert(vec != NULL);													\
+																			\
+	return (vec->num_items);												\
+}																			\
+																			\
+/* return 0 if sucsses, and 1 if fail */									\
+static DYN_VEC_INLINE int DynVec_##name##_Reserve(dyn_vec_##name##_t *vec,	\
+												  size_t new_capacity)		\
+{																			\
+	type *new_start = NULL;													\
+																			\
+	assert(vec != NULL);													\
+	assert(vec->num_items < new_capacity);									\
+																			\
+	new_start = (type *)realloc(vec->start, new_capacity * sizeof(type));	\
+	if (NULL == new_start)													\
+	{																		\
+		return (1);															\
+	}																		\
+																			\
+	vec->start = new_start;													\
+	vec->num_items = new_capacity;											\
+																			\
+	return (0);																\
+}																			\
+																			\
+/* growth_percent > 100: 150 grows by 1.5x, the default 200 doubles */		\
+static DYN_VEC_INLINE void DynVec_##name##_SetGrowthFactor(					\
+						dyn_vec_##name##_t *vec, size_t growth_percent)		\
+{																			\
+	assert(vec != NULL);													\
+	assert(growth_percent > 100);											\
+																			\
+	vec->growth_percent = growth_percent;									\
+}																			\
+																			\
+/* return 0 if sucsses, and 1 if fail */									\
+static DYN_VEC_INLINE int DynVec_##name##_PushBack(dyn_vec_##name##_t *vec,	\
+												   type item)				\
+{																			\
+	assert(vec != NULL);													\
+																			\
+	if ((vec->size == vec->num_items) &&									\
+		(DynVec_##name##_Reserve(vec, DYN_VEC_GROWN_CAPACITY(				\
+							vec->num_items, vec->growth_percent))))			\
+	{																		\
+		return (1);															\
+	}																		\
+																			\
+	vec->start[vec->size] = item;											\
+	++vec->size;															\
+																			\
+	return (0);																\
+}																			\
+																			\
+static DYN_VEC_INLINE void DynVec_##name##_PopBack(dyn_vec_##name##_t *vec)	\
+{																			\
+	assert(vec != NULL);													\
+	assert(vec->size > 0);													\
+																			\
+	--vec->size;															\
+}																			\
+																			\
+static DYN_VEC_INLINE type *DynVec_##name##_GetItemAddress(					\
+							const dyn_vec_##name##_t *vec, size_t index)	\
+{																			\
+	assert(vec != NULL);													\
+	assert(vec->num_items > index);											\
+																			\
+	return (vec->start + index);											\
+}																			\
+																			\
+static DYN_VEC_INLINE type DynVec_##name##_Get(								\
+							const dyn_vec_##name##_t *vec, size_t index)	\
+{																			\
+	assert(vec != NULL);													\
+	assert(vec->size > index);												\
+																			\
+	return (vec->start[index]);												\
+}
+
+#endif /* DYN_VEC_TYPED_H */
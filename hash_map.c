@@ -0,0 +1,367 @@
+#include <stddef.h> /* for size_t */
+#include <stdint.h> /* for SIZE_MAX */
+#include <stdlib.h> /* for malloc */
+#include <string.h> /* for memcpy */
+#include <assert.h> /* for assert */
+
+#include "hash_map.h"
+
+#define HASH_MAP_MIN_CAPACITY (16) /* power of 2 */
+
+/* Every slot is {hash, data, key}. A hash of 0 marks an empty slot (the
+   hashes of the keys are never 0), and keeping the hash in the slot lets
+   the probes skip most of the is_equal calls, and the growth rehash none.
+   Remove shifts the rest of the probe run back, so there are no
+   tombstones. The map is kept at most 3/4 full. */
+
+typedef struct hash_map_slot
+{
+	size_t hash;
+	void *data;
+} hash_map_slot_t;
+
+struct hash_map
+{
+	char *slots;
+	size_t slot_size;		/* the slot header and the key, aligned */
+	size_t key_size;
+	size_t capacity;
+	size_t size;
+	void *params;
+	size_t (*hash)(const void *key, void *params);
+	int (*is_equal)(const void *key1, const void *key2, void *params);
+};
+
+/*******************************************************************************
+Slot() / SlotKey() - helper functions.
+*******************************************************************************/
+static hash_map_slot_t *Slot(const hash_map_t *map, size_t index)
+{
+	return ((hash_map_slot_t *)(map->slots + (index * map->slot_size)));
+}
+
+static void *SlotKey(hash_map_slot_t *slot)
+{
+	return (slot + 1);
+}
+
+/*******************************************************************************
+HashOf() - helper function - the hash of key, mixed so that its low bits
+		   (which pick the slot) depend on all of its bits. Never 0.
+*******************************************************************************/
+static size_t HashOf(const hash_map_t *map, const void *key)
+{
+	size_t hash = map->hash(key, map->params);
+
+#if SIZE_MAX > 0xFFFFFFFFUL
+	/* fmix64 of MurmurHash3 */
+	hash ^= hash >> 33;
+	hash *= 0xFF51AFD7ED558CCDUL;
+	hash ^= hash >> 33;
+	hash *= 0xC4CEB9FE1A85EC53UL;
+	hash ^= hash >> 33;
+#else
+	hash ^= hash >> 16;
+	hash *= 0x45D9F3BUL;
+	hash ^= hash >> 16;
+#endif
+
+	return ((0 == hash) ? 1 : hash);
+}
+
+/*******************************************************************************
+FindIndex() - helper function - the index of the slot of key, or of the empty
+			  slot where it would be.
+
+Time complexity: O(1) expected.
+*******************************************************************************/
+static size_t FindIndex(const hash_map_t *map, const void *key, size_t hash)
+{
+	size_t mask = map->capacity - 1;
+	size_t i = hash & mask;
+
+	for (;;)
+	{
+		hash_map_slot_t *slot = Slot(map, i);
+
+		if ((0 == slot->hash) ||
+			((hash == slot->hash) &&
+			 (1 == map->is_equal(SlotKey(slot), key, map->params))))
+		{
+			return (i);
+		}
+
+		i = (i + 1) & mask;
+	}
+}
+
+/*******************************************************************************
+Resize() - helper function - moves the entries to new_capacity slots.
+		   returns 0 on success, or 1 on failure (the map is unchanged).
+
+Time complexity: O(capacity).
+*******************************************************************************/
+static int Resize(hash_map_t *map, size_t new_capacity)
+{
+	char *old_slots = map->slots;
+	size_t old_capacity = map->capacity;
+	size_t mask = new_capacity - 1;
+	size_t i = 0;
+
+	map->slots = (char *)calloc(new_capacity, map->slot_size);
+	if (NULL == map->slots)
+	{
+		map->slots = old_slots;
+		return (1);
+	}
+
+	map->capacity = new_capacity;
+	for (i = 0; i < old_capacity; ++i)
+	{
+		hash_map_slot_t *from = (hash_map_slot_t *)(old_slots +
+													(i * map->slot_size));
+
+		if (0 != from->hash)
+		{
+			size_t j = from->hash & mask;
+
+			while (0 != Slot(map, j)->hash)
+			{
+				j = (j + 1) & mask;
+			}
+
+			memcpy(Slot(map, j), from, map->slot_size);
+		}
+	}
+
+	free(old_slots); old_slots = NULL;
+
+	return (0);
+}
+
+/*******************************************************************************
+HashMapCreate() - returns pointer to new hash map, or NULL on faliure.
+*******************************************************************************/
+hash_map_t *HashMapCreate(size_t key_size, void *params,
+						  size_t (*hash)(const void *key, void *params),
+						  int (*is_equal)(const void *key1, const void *key2,
+										  void *params))
+{
+	hash_map_t *new_map = NULL;
+	size_t align = sizeof(hash_map_slot_t);
+
+	assert(0 != key_size);
+	assert(hash != NULL);
+	assert(is_equal != NULL);
+
+	new_map = (hash_map_t *)malloc(sizeof(*new_map));
+	if (NULL == new_map)
+	{
+		return (NULL);
+	}
+
+	/* the keys of the next slots start aligned like the slot header */
+	new_map->slot_size = sizeof(hash_map_slot_t) +
+						 (((key_size + align - 1) / align) * align);
+	new_map->slots = (char *)calloc(HASH_MAP_MIN_CAPACITY, new_map->slot_size);
+	if (NULL == new_map->slots)
+	{
+		free(new_map); new_map = NULL;
+		return (NULL);
+	}
+
+	new_map->key_size = key_size;
+	new_map->capacity = HASH_MAP_MIN_CAPACITY;
+	new_map->size = 0;
+	new_map->params = params;
+	new_map->hash = hash;
+	new_map->is_equal = is_equal;
+
+	return (new_map);
+}
+
+/*******************************************************************************
+HashMapDestroy() - frees the map (not the data).
+
+Time complexity: O(1).
+*******************************************************************************/
+void HashMapDestroy(hash_map_t *map)
+{
+	assert(map != NULL);
+
+	free(map->slots); map->slots = NULL;
+	free(map); map = NULL;
+}
+
+/*******************************************************************************
+HashMapSize() - return the num of keys in map.
+
+Time complexity: O(1).
+*******************************************************************************/
+size_t HashMapSize(const hash_map_t *map)
+{
+	assert(map != NULL);
+
+	return (map->size);
+}
+
+/*******************************************************************************
+HashMapIsEmpty() - returns 1 if empty; 0 if not.
+
+Time complexity: O(1).
+*******************************************************************************/
+int HashMapIsEmpty(const hash_map_t *map)
+{
+	assert(map != NULL);
+
+	return (0 == map->size);
+}
+
+/*******************************************************************************
+HashMapInsert() - inserts key with data, or replaces the data of key.
+				  returns 0 on success, 1 on failure (the map is unchanged).
+
+Time complexity: O(1) amortized.
+*******************************************************************************/
+int HashMapInsert(hash_map_t *map, const void *key, void *data)
+{
+	hash_map_slot_t *slot = NULL;
+	size_t hash = 0;
+
+	assert(map != NULL);
+	assert(key != NULL);
+
+	hash = HashOf(map, key);
+	slot = Slot(map, FindIndex(map, key, hash));
+	if (0 != slot->hash)
+	{
+		slot->data = data;
+		return (0);
+	}
+
+	if (4 * (map->size + 1) > 3 * map->capacity)
+	{
+		if (0 != Resize(map, 2 * map->capacity))
+		{
+			return (1);
+		}
+
+		slot = Slot(map, FindIndex(map, key, hash));
+	}
+
+	slot->hash = hash;
+	slot->data = data;
+	memcpy(SlotKey(slot), key, map->key_size);
+	++map->size;
+
+	return (0);
+}
+
+/*******************************************************************************
+HashMapFind() - returns the data of key, or NULL.
+
+Time complexity: O(1) expected.
+*******************************************************************************/
+void *HashMapFind(const hash_map_t *map, const void *key)
+{
+	hash_map_slot_t *slot = NULL;
+
+	assert(map != NULL);
+	assert(key != NULL);
+
+	slot = Slot(map, FindIndex(map, key, HashOf(map, key)));
+
+	return ((0 != slot->hash) ? slot->data : NULL);
+}
+
+/*******************************************************************************
+HashMapRemove() - removes key, and returns its data, or NULL.
+				  The slots after it in its probe run are shifted back
+				  into the hole, when their home slot allows it.
+
+Time complexity: O(1) expected.
+*******************************************************************************/
+void *HashMapRemove(hash_map_t *map, const void *key)
+{
+	size_t mask = 0;
+	size_t i = 0;
+	size_t j = 0;
+	void *data = NULL;
+
+	assert(map != NULL);
+	assert(key != NULL);
+
+	mask = map->capacity - 1;
+	i = FindIndex(map, key, HashOf(map, key));
+	if (0 == Slot(map, i)->hash)
+	{
+		return (NULL);
+	}
+
+	data = Slot(map, i)->data;
+	for (j = (i + 1) & mask; 0 != Slot(map, j)->hash; j = (j + 1) & mask)
+	{
+		size_t home = Slot(map, j)->hash & mask;
+
+		/* j may move to the hole if its home is not in (i, j] */
+		if (((j > i) && ((home <= i) || (home > j))) ||
+			((j < i) && ((home <= i) && (home > j))))
+		{
+			memcpy(Slot(map, i), Slot(map, j), map->slot_size);
+			i = j;
+		}
+	}
+
+	Slot(map, i)->hash = 0;
+	--map->size;
+
+	return (data);
+}
+
+/*******************************************************************************
+HashMapForEach() - do_func on every key and its data, in no order.
+				   returns the value of do_func: if the value is a non-zero,
+				   stops iterations.
+
+Time complexity: O(capacity).
+*******************************************************************************/
+int HashMapForEach(hash_map_t *map, void *params,
+				   int (*do_func)(const void *key, void *data, void *params))
+{
+	size_t i = 0;
+	int status = 0;
+
+	assert(map != NULL);
+	assert(do_func != NULL);
+
+	for (i = 0; (i < map->capacity) && (0 == status); ++i)
+	{
+		hash_map_slot_t *slot = Slot(map, i);
+
+		if (0 != slot->hash)
+		{
+			status = do_func(SlotKey(slot), slot->data, params);
+		}
+	}
+
+	return (status);
+}
+
+/*******************************************************************************
+HashMapClear() - removes all the keys. The capacity doesn't change.
+
+Time complexity: O(capacity).
+*******************************************************************************/
+void HashMapClear(hash_map_t *map)
+{
+	size_t i = 0;
+
+	assert(map != NULL);
+
+	for (i = 0; i < map->capacity; ++i)
+	{
+		Slot(map, i)->hash = 0;
+	}
+
+	map->size = 0;
+}
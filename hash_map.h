@@ -0,0 +1,39 @@
+#ifndef HASH_MAP_H_
+#define HASH_MAP_H_
+
+#include <stddef.h> /* size_t */
+
+/* Hash map from keys of key_size bytes (copied into the map) to data
+   pointers, by open addressing with linear probing.
+   Find, Insert and Remove are O(1) expected. */
+
+typedef struct hash_map hash_map_t;
+
+hash_map_t *HashMapCreate(size_t key_size, void *params,
+			size_t (*hash)(const void *key, void *params),
+			int (*is_equal)(const void *key1, const void *key2, void *params));
+
+void HashMapDestroy(hash_map_t *map);
+
+size_t HashMapSize(const hash_map_t *map);
+
+int HashMapIsEmpty(const hash_map_t *map);
+
+/* inserts key, or replaces the data of key if it is in the map.
+   returns 0 on success, 1 on failure */
+int HashMapInsert(hash_map_t *map, const void *key, void *data);
+
+/* returns the data of key, or NULL if key is not in the map */
+void *HashMapFind(const hash_map_t *map, const void *key);
+
+/* returns the data of the removed key, or NULL if key is not in the map */
+void *HashMapRemove(hash_map_t *map, const void *key);
+
+/* returns the value of do_func: if the value is a non-zero, stops.
+   do_func must not insert or remove */
+int HashMapForEach(hash_map_t *map, void *params,
+				   int (*do_func)(const void *key, void *data, void *params));
+
+void HashMapClear(hash_map_t *map);
+
+#endif /* HASH_MAP_H_ */
@@ -0,0 +1,183 @@
+#include <stddef.h> /* for size_t */
+#include <stdint.h> /* for uint64_t */
+#include <assert.h> /* for assert */
+
+#include "hdr_hist.h"
+
+/* Values below HDR_HIST_SUB_BUCKETS have a bucket each. Above them, the
+   value with its highest bit at msb goes to the bucket of its next
+   HDR_HIST_SUB_BITS bits, in the group of msb - HDR_HIST_SUB_BITS + 1. */
+
+/*******************************************************************************
+BucketOf() - helper function - the index of the bucket of value.
+
+Time complexity: O(1).
+*******************************************************************************/
+static size_t BucketOf(uint64_t value)
+{
+	size_t shift = 0;
+
+	if (value < HDR_HIST_SUB_BUCKETS)
+	{
+		return ((size_t)value);
+	}
+
+	shift = (size_t)(63 - __builtin_clzll(value)) - HDR_HIST_SUB_BITS;
+
+	return (((shift + 1) * HDR_HIST_SUB_BUCKETS) +
+			(size_t)((value >> shift) & (HDR_HIST_SUB_BUCKETS - 1)));
+}
+
+/*******************************************************************************
+BucketHigh() - helper function - the highest value of the bucket at index.
+
+Time complexity: O(1).
+*******************************************************************************/
+static uint64_t BucketHigh(size_t index)
+{
+	size_t group = index / HDR_HIST_SUB_BUCKETS;
+	uint64_t sub = index % HDR_HIST_SUB_BUCKETS;
+	size_t shift = 0;
+
+	if (0 == group)
+	{
+		return (sub);
+	}
+
+	shift = group - 1;
+
+	return ((((HDR_HIST_SUB_BUCKETS + sub + 1) << shift) - 1));
+}
+
+/*******************************************************************************
+HdrHistInit() - empties hist.
+
+Time complexity: O(num of buckets).
+*******************************************************************************/
+void HdrHistInit(hdr_hist_t *hist)
+{
+	size_t i = 0;
+
+	assert(hist != NULL);
+
+	for (i = 0; i < HDR_HIST_NUM_BUCKETS; ++i)
+	{
+		hist->counts[i] = 0;
+	}
+
+	hist->count = 0;
+	hist->sum = 0;
+	hist->min = UINT64_MAX;
+	hist->max = 0;
+}
+
+/*******************************************************************************
+HdrHistRecord() - counts value in its bucket.
+
+Time complexity: O(1).
+*******************************************************************************/
+void HdrHistRecord(hdr_hist_t *hist, uint64_t value)
+{
+	assert(hist != NULL);
+
+	++hist->counts[BucketOf(value)];
+	++hist->count;
+	hist->sum += value;
+
+	if (value < hist->min)
+	{
+		hist->min = value;
+	}
+
+	if (value > hist->max)
+	{
+		hist->max = value;
+	}
+}
+
+/*******************************************************************************
+HdrHistMerge() - adds the counts of src to dest.
+
+Time complexity: O(num of buckets).
+*******************************************************************************/
+void HdrHistMerge(hdr_hist_t *dest, const hdr_hist_t *src)
+{
+	size_t i = 0;
+
+	assert(dest != NULL);
+	assert(src != NULL);
+
+	for (i = 0; i < HDR_HIST_NUM_BUCKETS; ++i)
+	{
+		dest->counts[i] += src->counts[i];
+	}
+
+	dest->count += src->count;
+	dest->sum += src->sum;
+
+	if (src->min < dest->min)
+	{
+		dest->min = src->min;
+	}
+
+	if (src->max > dest->max)
+	{
+		dest->max = src->max;
+	}
+}
+
+/*******************************************************************************
+HdrHistPercentile() - walks the buckets up to the one of the rank of
+					  percentile.
+
+Time complexity: O(num of buckets).
+*******************************************************************************/
+uint64_t HdrHistPercentile(const hdr_hist_t *hist, double percentile)
+{
+	uint64_t rank = 0;
+	uint64_t seen = 0;
+	size_t i = 0;
+
+	assert(hist != NULL);
+	assert((percentile >= 0) && (percentile <= 100));
+
+	if (0 == hist->count)
+	{
+		return (0);
+	}
+
+	/* the rank of the value, from 1 */
+	rank = (uint64_t)((percentile / 100) * (double)hist->count + 0.5);
+	if (0 == rank)
+	{
+		rank = 1;
+	}
+
+	for (i = 0; i < HDR_HIST_NUM_BUCKETS; ++i)
+	{
+		seen += hist->counts[i];
+		if (seen >= rank)
+		{
+			break;
+		}
+	}
+
+	return ((BucketHigh(i) < hist->max) ? BucketHigh(i) : hist->max);
+}
+
+/*******************************************************************************
+HdrHistMean() - the mean of the recorded values.
+
+Time complexity: O(1).
+*******************************************************************************/
+double HdrHistMean(const hdr_hist_t *hist)
+{
+	assert(hist != NULL);
+
+	if (0 == hist->count)
+	{
+		return (0);
+	}
+
+	return ((double)hist->sum / (double)hist->count);
+}
@@ -0,0 +1,39 @@
+#ifndef HDR_HIST_H_
+#define HDR_HIST_H_
+
+#include <stdint.h> /* uint64_t */
+
+/* Log-linear histogram of non-negative integer values (HDR-style): every
+   power of 2 is split into HDR_HIST_SUB_BUCKETS equal buckets, so a value
+   is kept within 1 / HDR_HIST_SUB_BUCKETS of itself, over all of uint64_t,
+   in a fixed size struct (which may be copied as a snapshot).
+   Record is O(1) and allocates nothing. */
+
+#define HDR_HIST_SUB_BITS (3)
+#define HDR_HIST_SUB_BUCKETS (1 << HDR_HIST_SUB_BITS)
+#define HDR_HIST_NUM_BUCKETS ((64 - HDR_HIST_SUB_BITS + 1) * HDR_HIST_SUB_BUCKETS)
+
+typedef struct hdr_hist
+{
+	uint64_t counts[HDR_HIST_NUM_BUCKETS];
+	uint64_t count;
+	uint64_t sum;		/* wraps around on overflow */
+	uint64_t min;
+	uint64_t max;
+} hdr_hist_t;
+
+void HdrHistInit(hdr_hist_t *hist);
+
+void HdrHistRecord(hdr_hist_t *hist, uint64_t value);
+
+/* adds the values of src to dest */
+void HdrHistMerge(hdr_hist_t *dest, const hdr_hist_t *src);
+
+/* the value at percentile (0 - 100): the highest value of its bucket,
+   not above the max. 0 if the histogram is empty */
+uint64_t HdrHistPercentile(const hdr_hist_t *hist, double percentile);
+
+/* 0 if the histogram is empty */
+double HdrHistMean(const hdr_hist_t *hist);
+
+#endif /* HDR_HIST_H_ */
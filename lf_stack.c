@@ -0,0 +1,449 @@
+#define _POSIX_C_SOURCE 200112L /* for posix_memalign */
+#include <string.h> /* for memcpy */
+#include <stdlib.h> /* for malloc */
+#include <assert.h> /* for assert */
+#include "lf_stack.h"
+
+#define LF_STACK_CACHE_LINE (64)
+#define LF_STACK_ELIMINATION_SLOTS (16) /* power of 2 */
+#define LF_STACK_ELIMINATION_SPINS (128)
+
+#if defined(__x86_64__) || defined(__i386__)
+#define LF_STACK_PAUSE() __builtin_ia32_pause()
+#else
+#define LF_STACK_PAUSE() ((void)0)
+#endif
+
+typedef struct lf_node lf_node_t;
+
+struct lf_node
+{
+	lf_node_t *next;
+	char element[1];
+};
+
+/* {pointer, counter} - every successful CAS increments the counter */
+typedef struct lf_head
+{
+	lf_node_t *node;
+	size_t tag;
+} __attribute__((aligned(16))) lf_head_t;
+
+/* every head on its own cache line */
+typedef struct lf_padded_head
+{
+	lf_head_t head;
+	char pad[LF_STACK_CACHE_LINE - sizeof(lf_head_t)];
+} lf_padded_head_t;
+
+struct lf_stack
+{
+	lf_padded_head_t items;
+	lf_padded_head_t free_nodes;	/* popped nodes, reused by push */
+	lf_padded_head_t elimination[LF_STACK_ELIMINATION_SLOTS];
+	size_t size_of_element;
+	size_t num_of_elements;
+};
+
+static __thread unsigned int g_slot_seed;
+
+/****************************************************************
+Helper functions - atomic access to a tagged head
+****************************************************************/
+static lf_head_t HeadLoad(lf_head_t *head)
+{
+	lf_head_t res;
+
+	__atomic_load(head, &res, __ATOMIC_ACQUIRE);
+
+	return (res);
+}
+
+static int HeadCAS(lf_head_t *head, lf_head_t *expected, lf_node_t *node)
+{
+	lf_head_t desired;
+
+	desired.node = node;
+	desired.tag = expected->tag + 1;
+
+	return (__atomic_compare_exchange(head, expected, &desired, 0,
+									  __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE));
+}
+
+/* a stale reader may still look at next of a reused node */
+static lf_node_t *NodeNext(lf_node_t *node)
+{
+	return (__atomic_load_n(&node->next, __ATOMIC_RELAXED));
+}
+
+static void NodeSetNext(lf_node_t *node, lf_node_t *next)
+{
+	__atomic_store_n(&node->next, next, __ATOMIC_RELAXED);
+}
+
+/****************************************************************
+Helper function - a random elimination slot per call
+****************************************************************/
+static lf_head_t *EliminationSlot(lf_stack_t *stack)
+{
+	g_slot_seed = g_slot_seed * 1103515245u + 12345u;
+
+	return (&stack->elimination[(g_slot_seed >> 16) & 
+								(LF_STACK_ELIMINATION_SLOTS - 1)].head);
+}
+
+/****************************************************************
+Helper function - a pusher that lost the CAS on the head offers
+its node in an elimination slot for a while.
+return 1 if a popper took the node, 0 if not.
+****************************************************************/
+static int EliminatePush(lf_stack_t *stack, lf_node_t *node)
+{
+	lf_head_t *slot = EliminationSlot(stack);
+	lf_head_t expected = HeadLoad(slot);
+	int i = 0;
+
+	if ((NULL != expected.node) || (0 == HeadCAS(slot, &expected, node)))
+	{
+		return (0);
+	}
+
+	/* the slot holds {node, tag + 1} now */
+	++expected.tag;
+	expected.node = node;
+
+	for (i = 0; i < LF_STACK_ELIMINATION_SPINS; ++i)
+	{
+		LF_STACK_PAUSE();
+	}
+
+	/* withdraw - fails only if a popper took the node meanwhile */
+	return (0 == HeadCAS(slot, &expected, NULL));
+}
+
+/****************************************************************
+Helper function - a popper that lost the CAS on the head takes
+a node offered in an elimination slot, if there is one.
+return the node, or NULL.
+****************************************************************/
+static lf_node_t *EliminatePop(lf_stack_t *stack)
+{
+	lf_head_t *slot = EliminationSlot(stack);
+	lf_head_t expected = HeadLoad(slot);
+	lf_node_t *node = expected.node;
+
+	if ((NULL != node) && (HeadCAS(slot, &expected, NULL)))
+	{
+		return (node);
+	}
+
+	return (NULL);
+}
+
+/****************************************************************
+Helper function - pushes the chain first..last on head
+****************************************************************/
+static void PushChain(lf_head_t *head, lf_node_t *first, lf_node_t *last)
+{
+	lf_head_t expected = HeadLoad(head);
+
+	do
+	{
+		NodeSetNext(last, expected.node);
+	}
+	while (0 == HeadCAS(head, &expected, first));
+}
+
+/****************************************************************
+Helper function - pops a node from head, without elimination.
+return NULL if empty.
+****************************************************************/
+static lf_node_t *PopNode(lf_head_t *head)
+{
+	lf_head_t expected = HeadLoad(head);
+
+	/* the nodes are never freed while the stack lives,
+	   so reading next of a node that was popped meanwhile is safe */
+	while ((NULL != expected.node) && 
+		   (0 == HeadCAS(head, &expected, NodeNext(expected.node))))
+	{
+	}
+
+	return (expected.node);
+}
+
+/****************************************************************
+Helper function - a node from the free list, or a new one
+****************************************************************/
+static lf_node_t *NodeAlloc(lf_stack_t *stack)
+{
+	lf_node_t *node = PopNode(&stack->free_nodes.head);
+
+	if (NULL == node)
+	{
+		node = (lf_node_t *)malloc(sizeof(lf_node_t) + 
+								   stack->size_of_element);
+	}
+
+	return (node);
+}
+
+
+/****************************************************************
+Resived element_size, and return pointer to an empty Stack,
+if the allocation is fail return NULL
+****************************************************************/
+lf_stack_t *LFStackCreate(size_t element_size)
+{
+	lf_stack_t *new_stack = NULL;
+
+	assert(0 != element_size);
+
+	if (0 != posix_memalign((void **)&new_stack, LF_STACK_CACHE_LINE, 
+							sizeof(*new_stack)))
+	{
+		return (NULL);
+	}
+
+	memset(new_stack, 0, sizeof(*new_stack));
+	new_stack->size_of_element = element_size;
+
+	return (new_stack);
+}
+
+
+/****************************************************************
+Destroy the Stack and free the memory of all the nodes
+****************************************************************/
+void LFStackDestroy(lf_stack_t *stack)
+{
+	lf_node_t *node = NULL;
+	size_t i = 0;
+
+	assert(NULL != stack);
+
+	while (NULL != (node = PopNode(&stack->items.head)))
+	{
+		free(node);
+	}
+
+	while (NULL != (node = PopNode(&stack->free_nodes.head)))
+	{
+		free(node);
+	}
+
+	for (i = 0; i < LF_STACK_ELIMINATION_SLOTS; ++i)
+	{
+		free(stack->elimination[i].head.node);
+	}
+
+	free(stack); stack = NULL;
+}
+
+
+/****************************************************************
+Inserts a copy of element at the top of the Stack.
+Under contention, a push can be handed directly to a concurrent
+pop through the elimination slots.
+return 0 if sucsses, and -1 if the allocation is fail.
+****************************************************************/
+int LFStackPush(lf_stack_t *stack, const void *element)
+{
+	lf_node_t *node = NULL;
+	lf_head_t expected;
+
+	assert(NULL != element);
+	assert(NULL != stack);
+
+	node = NodeAlloc(stack);
+	if (NULL == node)
+	{
+		return (-1);
+	}
+
+	memcpy(node->element, element, stack->size_of_element);
+	__atomic_fetch_add(&stack->num_of_elements, 1, __ATOMIC_RELAXED);
+
+	expected = HeadLoad(&stack->items.head);
+	for (;;)
+	{
+		NodeSetNext(node, expected.node);
+		if (HeadCAS(&stack->items.head, &expected, node))
+		{
+			return (0);
+		}
+
+		if (EliminatePush(stack, node))
+		{
+			return (0);
+		}
+
+		expected = HeadLoad(&stack->items.head);
+	}
+}
+
+
+/****************************************************************
+Copies the object at the top of the Stack and removes it.
+return 0 if sucsses, and -1 if the stack is empty.
+****************************************************************/
+int LFStackPop(lf_stack_t *stack, void *element)
+{
+	lf_node_t *node = NULL;
+	lf_head_t expected;
+
+	assert(NULL != element);
+	assert(NULL != stack);
+
+	expected = HeadLoad(&stack->items.head);
+	for (;;)
+	{
+		node = expected.node;
+		if (NULL == node)
+		{
+			return (-1);
+		}
+
+		if (HeadCAS(&stack->items.head, &expected, NodeNext(node)))
+		{
+			break;
+		}
+
+		node = EliminatePop(stack);
+		if (NULL != node)
+		{
+			break;
+		}
+
+		expected = HeadLoad(&stack->items.head);
+	}
+
+	memcpy(element, node->element, stack->size_of_element);
+	__atomic_fetch_sub(&stack->num_of_elements, 1, __ATOMIC_RELAXED);
+	PushChain(&stack->free_nodes.head, node, node);
+
+	return (0);
+}
+
+
+/****************************************************************
+Links the n elements into a private chain, then pushes the whole
+chain with one CAS.
+return 0 if sucsses, and -1 if the allocation is fail.
+****************************************************************/
+int LFStackPushBatch(lf_stack_t *stack, const void *elements, size_t n)
+{
+	const char *element = (const char *)elements;
+	lf_node_t *first = NULL;
+	lf_node_t *last = NULL;
+	size_t i = 0;
+
+	assert(NULL != stack);
+	assert((NULL != elements) || (0 == n));
+
+	for (i = 0; i < n; ++i)
+	{
+		lf_node_t *node = NodeAlloc(stack);
+
+		if (NULL == node)
+		{
+			if (NULL != first)
+			{
+				PushChain(&stack->free_nodes.head, first, last);
+			}
+			return (-1);
+		}
+
+		memcpy(node->element, element + (i * stack->size_of_element), 
+			   stack->size_of_element);
+
+		/* the last element goes on top */
+		NodeSetNext(node, first);
+		first = node;
+		if (NULL == last)
+		{
+			last = node;
+		}
+	}
+
+	if (NULL != first)
+	{
+		__atomic_fetch_add(&stack->num_of_elements, n, __ATOMIC_RELAXED);
+		PushChain(&stack->items.head, first, last);
+	}
+
+	return (0);
+}
+
+
+/****************************************************************
+Detaches up to max nodes from the top with one CAS, and copies
+their elements out (the top one first).
+return the num of popped elements.
+****************************************************************/
+size_t LFStackPopBatch(lf_stack_t *stack, void *elements, size_t max)
+{
+	char *element = (char *)elements;
+	lf_head_t expected;
+	lf_node_t *last = NULL;
+	lf_node_t *next = NULL;
+	lf_node_t *node = NULL;
+	size_t count = 0;
+	size_t i = 0;
+
+	assert(NULL != stack);
+	assert((NULL != elements) || (0 == max));
+
+	if (0 == max)
+	{
+		return (0);
+	}
+
+	expected = HeadLoad(&stack->items.head);
+	do
+	{
+		/* the chain can't change under the head without changing its tag,
+		   so a successful CAS means the walk saw a consistent chain */
+		last = expected.node;
+		if (NULL == last)
+		{
+			return (0);
+		}
+
+		/* next is loaded once a step: a popped node may be recycled (and
+		   its next changed) at any time */
+		count = 1;
+		next = NodeNext(last);
+		while ((count < max) && (NULL != next))
+		{
+			last = next;
+			++count;
+			next = NodeNext(last);
+		}
+	}
+	while (0 == HeadCAS(&stack->items.head, &expected, next));
+
+	node = expected.node;
+	for (i = 0; i < count; ++i)
+	{
+		memcpy(element + (i * stack->size_of_element), node->element, 
+			   stack->size_of_element);
+		node = node->next;
+	}
+
+	__atomic_fetch_sub(&stack->num_of_elements, count, __ATOMIC_RELAXED);
+	PushChain(&stack->free_nodes.head, expected.node, last);
+
+	return (count);
+}
+
+
+/****************************************************************
+Return the num of the element in the Stack
+****************************************************************/
+size_t LFStackSize(const lf_stack_t *stack)
+{
+	assert(NULL != stack);
+
+	return (__atomic_load_n(&stack->num_of_elements, __ATOMIC_RELAXED));
+}
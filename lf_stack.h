@@ -0,0 +1,30 @@
+#ifndef LF_STACK_H_
+#define LF_STACK_H_
+#include <stddef.h> /* size_t */
+
+/* Lock-free LIFO (Treiber stack) for many threads.
+   Elements are copied in and out (element_size bytes), like stack_t -
+   with element_size == sizeof(void *) it is a stack of pointers.
+   The heads are tagged {pointer, counter} pairs updated by double-width
+   CAS (link with -latomic), so ABA can't corrupt the stack. */
+
+typedef struct lf_stack lf_stack_t;
+
+lf_stack_t *LFStackCreate(size_t element_size);
+/* no other thread may use the stack during destroy */
+void LFStackDestroy(lf_stack_t *stack);
+/* return 0 if sucsses, and -1 if fail */
+int LFStackPush(lf_stack_t *stack, const void *element);
+/* copies the top element to element and removes it.
+   return 0 if sucsses, and -1 if the stack is empty */
+int LFStackPop(lf_stack_t *stack, void *element);
+/* pushes n elements with one CAS, elements[n - 1] ends on top.
+   return 0 if sucsses, and -1 if fail (nothing is pushed) */
+int LFStackPushBatch(lf_stack_t *stack, const void *elements, size_t n);
+/* pops up to max elements with one CAS, the top one first.
+   return the num of popped elements */
+size_t LFStackPopBatch(lf_stack_t *stack, void *elements, size_t max);
+/* exact only when no other thread is pushing or popping */
+size_t LFStackSize(const lf_stack_t *stack);
+
+#endif /* LF_STACK_H_ */
@@ -0,0 +1,377 @@
+#define _POSIX_C_SOURCE 200112L /* for posix_memalign */
+#include <stddef.h> /* for size_t */
+#include <stdlib.h> /* for malloc, posix_memalign */
+#include <pthread.h> /* for pthread_mutex_t */
+#include <unistd.h> /* for sysconf */
+#include <assert.h> /* for assert */
+
+#include "multi_pq.h"
+#include "pq.h"
+
+#define MULTI_PQ_CACHE_LINE (64)
+#define MULTI_PQ_TRY_LOCKS (8) /* then the locks are waited for */
+
+struct multi_pq_queue
+{
+	pthread_mutex_t lock;
+	pq_t *pq;
+};
+
+/* every queue on its own cache lines */
+typedef union multi_pq_padded_queue
+{
+	struct multi_pq_queue queue;
+	char pad[((sizeof(struct multi_pq_queue) / MULTI_PQ_CACHE_LINE) + 1) *
+			 MULTI_PQ_CACHE_LINE];
+} multi_pq_padded_queue_t;
+
+struct multi_pq
+{
+	void *params;
+	int (*is_before)(const void *data1, const void *data2, void *params);
+	size_t num_queues;
+	size_t size;					/* atomic */
+	multi_pq_padded_queue_t *queues;
+};
+
+static __thread unsigned int g_queue_seed;
+
+/*******************************************************************************
+RandomQueue() - helper function - a random queue, by a generator of every
+				thread (seeded by the address of its own seed).
+*******************************************************************************/
+static struct multi_pq_queue *RandomQueue(const multi_pq_t *pq)
+{
+	if (0 == g_queue_seed)
+	{
+		g_queue_seed = (unsigned int)(size_t)&g_queue_seed | 1;
+	}
+
+	g_queue_seed = g_queue_seed * 1103515245u + 12345u;
+
+	return (&pq->queues[(g_queue_seed >> 8) % pq->num_queues].queue);
+}
+
+/*******************************************************************************
+DequeueFirstOf() - helper function - dequeues from q1 or q2, whichever front
+				   is before the other, with both of them locked.
+				   q1 may be q2. The locks are released.
+*******************************************************************************/
+static void *DequeueFirstOf(const multi_pq_t *pq, struct multi_pq_queue *q1,
+							struct multi_pq_queue *q2)
+{
+	struct multi_pq_queue *from = q1;
+	void *data = NULL;
+
+	if (q1 != q2)
+	{
+		void *front1 = PQPeek(q1->pq);
+		void *front2 = PQPeek(q2->pq);
+
+		if ((NULL == front1) ||
+			((NULL != front2) &&
+			 (1 == pq->is_before(front2, front1, pq->params))))
+		{
+			from = q2;
+		}
+	}
+
+	data = PQDequeue(from->pq);
+
+	pthread_mutex_unlock(&q1->lock);
+	if (q1 != q2)
+	{
+		pthread_mutex_unlock(&q2->lock);
+	}
+
+	return (data);
+}
+
+/*******************************************************************************
+DequeueAny() - helper function - dequeues from the first queue which is not
+			   empty, waiting for every lock in its turn.
+			   Returns NULL if all the queues are empty.
+
+Time complexity: O(num_queues + log n).
+*******************************************************************************/
+static void *DequeueAny(multi_pq_t *pq)
+{
+	size_t i = 0;
+
+	for (i = 0; i < pq->num_queues; ++i)
+	{
+		struct multi_pq_queue *queue = &pq->queues[i].queue;
+		void *data = NULL;
+
+		pthread_mutex_lock(&queue->lock);
+		data = PQDequeue(queue->pq);
+		pthread_mutex_unlock(&queue->lock);
+
+		if (NULL != data)
+		{
+			return (data);
+		}
+	}
+
+	return (NULL);
+}
+
+/*******************************************************************************
+MultiPQCreate() - creates a multi queue and returns a pointer to it,
+				  or NULL on failure.
+*******************************************************************************/
+multi_pq_t *MultiPQCreate(void *params, int (*is_before)(const void *data1,
+														 const void *data2,
+														 void *params),
+						  size_t num_queues, int is_strict)
+{
+	multi_pq_t *res = NULL;
+	size_t i = 0;
+
+	assert(is_before != NULL);
+	assert((0 == is_strict) || (1 == is_strict));
+
+	if (1 == is_strict)
+	{
+		num_queues = 1;
+	}
+	else if (0 == num_queues)
+	{
+		long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+
+		num_queues = (cpus > 0) ? (2 * (size_t)cpus) : 2;
+	}
+
+	res = (multi_pq_t *)malloc(sizeof(*res));
+	if (NULL == res)
+	{
+		return (NULL);
+	}
+
+	/* the padding keeps every queue on its own lines only when aligned */
+	if (0 != posix_memalign((void **)&res->queues, MULTI_PQ_CACHE_LINE,
+							num_queues * sizeof(multi_pq_padded_queue_t)))
+	{
+		free(res); res = NULL;
+		return (NULL);
+	}
+
+	for (i = 0; i < num_queues; ++i)
+	{
+		struct multi_pq_queue *queue = &res->queues[i].queue;
+
+		queue->pq = PQCreate(params, is_before);
+		if ((NULL == queue->pq) ||
+			(0 != pthread_mutex_init(&queue->lock, NULL)))
+		{
+			if (NULL != queue->pq)
+			{
+				PQDestroy(queue->pq);
+			}
+
+			res->num_queues = i;
+			MultiPQDestroy(res); res = NULL;
+			return (NULL);
+		}
+	}
+
+	res->params = params;
+	res->is_before = is_before;
+	res->num_queues = num_queues;
+	res->size = 0;
+
+	return (res);
+}
+
+/*******************************************************************************
+MultiPQDestroy() - frees the queue (not the elements).
+
+Time complexity: O(num_queues).
+*******************************************************************************/
+void MultiPQDestroy(multi_pq_t *pq)
+{
+	size_t i = 0;
+
+	assert(pq != NULL);
+
+	for (i = 0; i < pq->num_queues; ++i)
+	{
+		pthread_mutex_destroy(&pq->queues[i].queue.lock);
+		PQDestroy(pq->queues[i].queue.pq);
+	}
+
+	free(pq->queues); pq->queues = NULL;
+	free(pq); pq = NULL;
+}
+
+/*******************************************************************************
+MultiPQSize() - return the num of elements held in pq.
+
+Time complexity: O(1).
+*******************************************************************************/
+size_t MultiPQSize(const multi_pq_t *pq)
+{
+	assert(pq != NULL);
+
+	return (__atomic_load_n(&pq->size, __ATOMIC_RELAXED));
+}
+
+/*******************************************************************************
+MultiPQIsempty() - return 1 if queue is empty, or 0 otherwise.
+
+Time complexity: O(1).
+*******************************************************************************/
+int MultiPQIsempty(const multi_pq_t *pq)
+{
+	assert(pq != NULL);
+
+	return (0 == MultiPQSize(pq));
+}
+
+/*******************************************************************************
+MultiPQEnqueue() - Enqueues a new element into a random queue, skipping the
+				   queues which are locked.
+				 - returns 0 on sucess or 1 on failure
+
+Time complexity: O(log n).
+*******************************************************************************/
+int MultiPQEnqueue(multi_pq_t *pq, void *data)
+{
+	struct multi_pq_queue *queue = NULL;
+	int status = 0;
+	size_t i = 0;
+
+	assert(pq != NULL);
+
+	do
+	{
+		queue = RandomQueue(pq);
+		++i;
+	} while ((0 != pthread_mutex_trylock(&queue->lock)) &&
+			 ((i < MULTI_PQ_TRY_LOCKS) ||
+			  (0 != pthread_mutex_lock(&queue->lock))));
+
+	/* counted before it can be dequeued, so size never goes below 0 */
+	status = PQEnqueue(queue->pq, data);
+	if (0 == status)
+	{
+		__atomic_add_fetch(&pq->size, 1, __ATOMIC_RELAXED);
+	}
+
+	pthread_mutex_unlock(&queue->lock);
+
+	return (status);
+}
+
+/*******************************************************************************
+MultiPQDequeue() - removes an element near the front, and returns its data:
+				   the front of two random queues which is before the other.
+				   Locked queues are skipped a few times, then the queues are
+				   waited for. returns NULL if all the queues are empty.
+
+Time complexity: O(log n) expected.
+*******************************************************************************/
+void *MultiPQDequeue(multi_pq_t *pq)
+{
+	size_t i = 0;
+
+	assert(pq != NULL);
+
+	while (0 != MultiPQSize(pq))
+	{
+		struct multi_pq_queue *q1 = RandomQueue(pq);
+		struct multi_pq_queue *q2 = RandomQueue(pq);
+		void *data = NULL;
+
+		if (i < MULTI_PQ_TRY_LOCKS)
+		{
+			++i;
+			if (0 != pthread_mutex_trylock(&q1->lock))
+			{
+				continue;
+			}
+
+			if ((q1 != q2) && (0 != pthread_mutex_trylock(&q2->lock)))
+			{
+				pthread_mutex_unlock(&q1->lock);
+				continue;
+			}
+
+			data = DequeueFirstOf(pq, q1, q2);
+		}
+		else
+		{
+			/* few elements left, or the locks are busy */
+			data = DequeueAny(pq);
+			if (NULL == data)
+			{
+				return (NULL);
+			}
+		}
+
+		if (NULL != data)
+		{
+			__atomic_sub_fetch(&pq->size, 1, __ATOMIC_RELAXED);
+			return (data);
+		}
+	}
+
+	return (NULL);
+}
+
+/*******************************************************************************
+MultiPQClear() - Clears all elements from the queue.
+
+Time complexity: O(num_queues).
+*******************************************************************************/
+void MultiPQClear(multi_pq_t *pq)
+{
+	size_t i = 0;
+
+	assert(pq != NULL);
+
+	for (i = 0; i < pq->num_queues; ++i)
+	{
+		struct multi_pq_queue *queue = &pq->queues[i].queue;
+
+		pthread_mutex_lock(&queue->lock);
+		__atomic_sub_fetch(&pq->size, PQSize(queue->pq), __ATOMIC_RELAXED);
+		PQClear(queue->pq);
+		pthread_mutex_unlock(&queue->lock);
+	}
+}
+
+/*******************************************************************************
+MultiPQRemove() - find a spesific element according to params, and return its
+				  data. If didn't find anything returns NULL.
+
+Time complexity: O(n).
+*******************************************************************************/
+void *MultiPQRemove(multi_pq_t *pq, const void *to_find, void *params,
+					int (*is_match)(const void *data,
+					const void *to_find,
+					void *params))
+{
+	size_t i = 0;
+
+	assert(pq != NULL);
+	assert(is_match != NULL);
+
+	for (i = 0; i < pq->num_queues; ++i)
+	{
+		struct multi_pq_queue *queue = &pq->queues[i].queue;
+		void *data = NULL;
+
+		pthread_mutex_lock(&queue->lock);
+		data = PQRemove(queue->pq, to_find, params, is_match);
+		pthread_mutex_unlock(&queue->lock);
+
+		if (NULL != data)
+		{
+			__atomic_sub_fetch(&pq->size, 1, __ATOMIC_RELAXED);
+			return (data);
+		}
+	}
+
+	return (NULL);
+}
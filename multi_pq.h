@@ -0,0 +1,43 @@
+#ifndef MULTI_PQ_H_
+#define MULTI_PQ_H_
+
+#include <stddef.h> /* size_t */
+
+/* Priority queue for many producer and consumer threads (a MultiQueue):
+   num_queues pq_t's, each under its own lock. Enqueue goes to a random
+   queue, Dequeue takes the better of the fronts of two random queues.
+   Relaxed: a dequeued element is near the front, not always the front.
+   Strict: one queue, so the order is exact (and every call contends). */
+
+typedef struct multi_pq multi_pq_t;
+
+/* num_queues == 0 - 2 queues for every online cpu.
+   is_strict == 1 - one queue (num_queues is ignored) */
+multi_pq_t *MultiPQCreate(void *params,
+			int (*is_before)(const void *data1,
+			const void *data2,
+			void *params),
+			size_t num_queues, int is_strict);
+
+/* no other thread may use the queue during destroy */
+void MultiPQDestroy(multi_pq_t *pq);
+
+/* exact only when no other thread is enqueueing or dequeueing */
+size_t MultiPQSize(const multi_pq_t *pq);
+
+int MultiPQIsempty(const multi_pq_t *pq);
+
+/* returns 0 on success, 1 on failure */
+int MultiPQEnqueue(multi_pq_t *pq, void *data);
+
+/* NULL if all the queues are empty */
+void *MultiPQDequeue(multi_pq_t *pq);
+
+void MultiPQClear(multi_pq_t *pq);
+
+void *MultiPQRemove(multi_pq_t *pq, const void *to_find, void *params,
+				int (*is_match)(const void *data,
+				const void *to_find,
+				void *params));
+
+#endif /* MULTI_PQ_H_ */
@@ -0,0 +1,400 @@
+#include <stddef.h> /* for size_t */
+#include <stdlib.h> /* for malloc */
+#include <assert.h> /* for assert */
+
+#include "pairing_heap.h"
+
+/* Every node holds its leftmost child and its right sibling.
+   prev is the left sibling, or the parent for a leftmost child
+   (NULL for the root), so a node is cut out in O(1). */
+
+struct pairing_node
+{
+	void *data;
+	pairing_node_t *child;
+	pairing_node_t *sibling;
+	pairing_node_t *prev;
+};
+
+struct pairing_heap
+{
+	pairing_node_t *root;
+	void *params;
+	int (*is_before)(const void *data1, const void *data2, void *params);
+	size_t size;
+};
+
+/*******************************************************************************
+Link() - helper function - links two roots (without siblings): the one which
+		 is after the other becomes the leftmost child of it.
+		 Returns the new root.
+
+Time complexity: O(1).
+*******************************************************************************/
+static pairing_node_t *Link(const pairing_heap_t *heap, pairing_node_t *first,
+							pairing_node_t *second)
+{
+	pairing_node_t *hold = NULL;
+
+	if (NULL == first)
+	{
+		return (second);
+	}
+
+	if (NULL == second)
+	{
+		return (first);
+	}
+
+	if (1 == heap->is_before(second->data, first->data, heap->params))
+	{
+		hold = first;
+		first = second;
+		second = hold;
+	}
+
+	second->prev = first;
+	second->sibling = first->child;
+	if (NULL != first->child)
+	{
+		first->child->prev = second;
+	}
+
+	first->child = second;
+
+	return (first);
+}
+
+/*******************************************************************************
+MergePairs() - helper function - links the list of siblings from first into
+			   one root: pairs from left to right, then the pairs from right
+			   to left.
+
+Time complexity: O(num of siblings).
+*******************************************************************************/
+static pairing_node_t *MergePairs(const pairing_heap_t *heap,
+								  pairing_node_t *first)
+{
+	pairing_node_t *pairs = NULL;
+	pairing_node_t *res = NULL;
+
+	/* the linked pairs are kept in reverse, through sibling */
+	while (NULL != first)
+	{
+		pairing_node_t *second = first->sibling;
+		pairing_node_t *next = NULL;
+		pairing_node_t *pair = NULL;
+
+		if (NULL != second)
+		{
+			next = second->sibling;
+			second->sibling = NULL;
+		}
+
+		first->sibling = NULL;
+		pair = Link(heap, first, second);
+		pair->sibling = pairs;
+		pairs = pair;
+		first = next;
+	}
+
+	while (NULL != pairs)
+	{
+		pairing_node_t *next = pairs->sibling;
+
+		pairs->sibling = NULL;
+		res = Link(heap, pairs, res);
+		pairs = next;
+	}
+
+	if (NULL != res)
+	{
+		res->prev = NULL;
+	}
+
+	return (res);
+}
+
+/*******************************************************************************
+Cut() - helper function - detaches node (with its children) from its parent.
+
+Time complexity: O(1).
+*******************************************************************************/
+static void Cut(pairing_node_t *node)
+{
+	if (node->prev->child == node)
+	{
+		node->prev->child = node->sibling;
+	}
+	else
+	{
+		node->prev->sibling = node->sibling;
+	}
+
+	if (NULL != node->sibling)
+	{
+		node->sibling->prev = node->prev;
+	}
+
+	node->sibling = NULL;
+	node->prev = NULL;
+}
+
+/*******************************************************************************
+PairingHeapCreate() - creates a pairing heap and returns a pointer to it,
+					  or NULL on failure.
+*******************************************************************************/
+pairing_heap_t *PairingHeapCreate(void *params,
+								  int (*is_before)(const void *data1,
+												   const void *data2,
+												   void *params))
+{
+	pairing_heap_t *res = NULL;
+
+	assert(is_before != NULL);
+
+	res = (pairing_heap_t *)malloc(sizeof(*res));
+	if (NULL == res)
+	{
+		return (NULL);
+	}
+
+	res->root = NULL;
+	res->params = params;
+	res->is_before = is_before;
+	res->size = 0;
+
+	return (res);
+}
+
+/*******************************************************************************
+PairingHeapDestroy() - frees the heap and all its nodes (not the data).
+
+Time complexity: O(n).
+*******************************************************************************/
+void PairingHeapDestroy(pairing_heap_t *heap)
+{
+	assert(heap != NULL);
+
+	PairingHeapClear(heap);
+
+	free(heap); heap = NULL;
+}
+
+/*******************************************************************************
+PairingHeapSize() - return the num of elements held in heap.
+
+Time complexity: O(1).
+*******************************************************************************/
+size_t PairingHeapSize(const pairing_heap_t *heap)
+{
+	assert(heap != NULL);
+
+	return (heap->size);
+}
+
+/*******************************************************************************
+PairingHeapIsempty() - return 1 if heap is empty, or 0 otherwise.
+
+Time complexity: O(1).
+*******************************************************************************/
+int PairingHeapIsempty(const pairing_heap_t *heap)
+{
+	assert(heap != NULL);
+
+	return (NULL == heap->root);
+}
+
+/*******************************************************************************
+PairingHeapInsert() - inserts data as a new root linked with the root.
+					  returns the handle of data, or NULL on failure.
+
+Time complexity: O(1).
+*******************************************************************************/
+pairing_node_t *PairingHeapInsert(pairing_heap_t *heap, void *data)
+{
+	pairing_node_t *node = NULL;
+
+	assert(heap != NULL);
+
+	node = (pairing_node_t *)malloc(sizeof(*node));
+	if (NULL == node)
+	{
+		return (NULL);
+	}
+
+	node->data = data;
+	node->child = NULL;
+	node->sibling = NULL;
+	node->prev = NULL;
+
+	heap->root = Link(heap, heap->root, node);
+	++heap->size;
+
+	return (node);
+}
+
+/*******************************************************************************
+PairingHeapDequeue() - removes the first element and returns its data.
+					   returns NULL if the heap is empty.
+
+Time complexity: O(log n) amortized.
+*******************************************************************************/
+void *PairingHeapDequeue(pairing_heap_t *heap)
+{
+	pairing_node_t *root = NULL;
+	void *data = NULL;
+
+	assert(heap != NULL);
+
+	root = heap->root;
+	if (NULL == root)
+	{
+		return (NULL);
+	}
+
+	data = root->data;
+	heap->root = MergePairs(heap, root->child);
+	--heap->size;
+
+	free(root); root = NULL;
+
+	return (data);
+}
+
+/*******************************************************************************
+PairingHeapPeek() - returns the data of the first element,
+					or NULL if the heap is empty.
+
+Time complexity: O(1).
+*******************************************************************************/
+void *PairingHeapPeek(const pairing_heap_t *heap)
+{
+	assert(heap != NULL);
+
+	if (NULL == heap->root)
+	{
+		return (NULL);
+	}
+
+	return (heap->root->data);
+}
+
+/*******************************************************************************
+PairingHeapMeld() - links the root of src with the root of dest.
+					src becomes empty.
+
+Time complexity: O(1).
+*******************************************************************************/
+void PairingHeapMeld(pairing_heap_t *dest, pairing_heap_t *src)
+{
+	assert(dest != NULL);
+	assert(src != NULL);
+	assert(dest != src);
+
+	dest->root = Link(dest, dest->root, src->root);
+	dest->size += src->size;
+
+	src->root = NULL;
+	src->size = 0;
+}
+
+/*******************************************************************************
+PairingHeapDecreaseKey() - cuts node out of its parent, and links it with the
+						   root.
+
+Time complexity: O(1), O(log n) amortized (the cost falls on Dequeue).
+*******************************************************************************/
+void PairingHeapDecreaseKey(pairing_heap_t *heap, pairing_node_t *node)
+{
+	assert(heap != NULL);
+	assert(node != NULL);
+
+	if (node == heap->root)
+	{
+		return;
+	}
+
+	Cut(node);
+	heap->root = Link(heap, heap->root, node);
+}
+
+/*******************************************************************************
+PairingHeapRemove() - removes node from heap, and returns its data.
+					  The children of node are merged, and linked with the
+					  root.
+
+Time complexity: O(log n) amortized.
+*******************************************************************************/
+void *PairingHeapRemove(pairing_heap_t *heap, pairing_node_t *node)
+{
+	void *data = NULL;
+
+	assert(heap != NULL);
+	assert(node != NULL);
+
+	if (node == heap->root)
+	{
+		return (PairingHeapDequeue(heap));
+	}
+
+	data = node->data;
+	Cut(node);
+	heap->root = Link(heap, heap->root, MergePairs(heap, node->child));
+	--heap->size;
+
+	free(node); node = NULL;
+
+	return (data);
+}
+
+/*******************************************************************************
+PairingHeapGetData() - returns the data of node.
+
+Time complexity: O(1).
+*******************************************************************************/
+void *PairingHeapGetData(const pairing_node_t *node)
+{
+	assert(node != NULL);
+
+	return (node->data);
+}
+
+/*******************************************************************************
+PairingHeapClear() - frees all the nodes of the heap.
+					 The children of every freed node go to the front of the
+					 list of nodes to free.
+
+Time complexity: O(n).
+*******************************************************************************/
+void PairingHeapClear(pairing_heap_t *heap)
+{
+	pairing_node_t *to_free = NULL;
+
+	assert(heap != NULL);
+
+	to_free = heap->root;
+	while (NULL != to_free)
+	{
+		pairing_node_t *node = to_free;
+
+		to_free = node->sibling;
+		if (NULL != node->child)
+		{
+			pairing_node_t *last = node->child;
+
+			while (NULL != last->sibling)
+			{
+				last = last->sibling;
+			}
+
+			last->sibling = to_free;
+			to_free = node->child;
+		}
+
+		free(node); node = NULL;
+	}
+
+	heap->root = NULL;
+	heap->size = 0;
+}
@@ -0,0 +1,53 @@
+#ifndef PAIRING_HEAP_H_
+#define PAIRING_HEAP_H_
+
+#include <stddef.h> /* size_t */
+
+/* Priority queue (by is_before, like pq_t) as a pairing heap:
+   Insert and Meld are O(1), Dequeue, DecreaseKey and Remove are
+   O(log n) amortized. Insert returns a handle of the element, which
+   stays valid until the element is dequeued or removed (also after
+   the heap is melded into another heap).
+   It is not a backend of pq.h: DecreaseKey needs the handles, which the
+   pq.h interface has no place for, and pq_t stays an array heap for its
+   other users (PQMeld there is O(m + n)). */
+
+typedef struct pairing_heap pairing_heap_t;
+typedef struct pairing_node pairing_node_t;
+
+pairing_heap_t *PairingHeapCreate(void *params,
+			int (*is_before)(const void *data1,
+			const void *data2,
+			void *params));
+
+void PairingHeapDestroy(pairing_heap_t *heap);
+
+size_t PairingHeapSize(const pairing_heap_t *heap);
+
+int PairingHeapIsempty(const pairing_heap_t *heap);
+
+/* returns the handle of data, or NULL on failure */
+pairing_node_t *PairingHeapInsert(pairing_heap_t *heap, void *data);
+
+/* NULL if the heap is empty */
+void *PairingHeapDequeue(pairing_heap_t *heap);
+
+/* NULL if the heap is empty */
+void *PairingHeapPeek(const pairing_heap_t *heap);
+
+/* moves all the elements of src to dest (both with the same is_before),
+   src becomes empty */
+void PairingHeapMeld(pairing_heap_t *dest, pairing_heap_t *src);
+
+/* the data of node was changed so it may be before its place -
+   never after it */
+void PairingHeapDecreaseKey(pairing_heap_t *heap, pairing_node_t *node);
+
+/* removes node from heap, and returns its data */
+void *PairingHeapRemove(pairing_heap_t *heap, pairing_node_t *node);
+
+void *PairingHeapGetData(const pairing_node_t *node);
+
+void PairingHeapClear(pairing_heap_t *heap);
+
+#endif /* PAIRING_HEAP_H_ */
@@ -1,184 +1,523 @@
-#include <stddef.h> /* for size_t */
-#include <stdlib.h> /* for malloc */
-#include <assert.h> /* for assert */
-
-#include "pq.h"
-#include "srt_list.h"
-
-
-struct pq 
-{
-	srt_list_t * srt_list;
-};
-
-/*******************************************************************************
-PQCreate() - creates a priority queue and returns a pointer to it.
-*******************************************************************************/
-pq_t *PQCreate (void *params, int(*is_before)(const void *data1,
-											  const void *data2,
-											  void *params))
-{
-	pq_t *res = NULL;
-
-	assert(is_before != NULL);
-
-	res = (pq_t *)malloc(sizeof(*res));
-	if (NULL == res)
-	{
-		return (NULL);
-	}
-
-	res->srt_list = SrtListCreate(params, is_before);
-	if (NULL == res->srt_list)
-	{
-		free(res); res = NULL;
-		return (NULL);
-	}
-
-	return (res);
-}
-
-/*******************************************************************************
-PQDestroy() - frees all nodes in a pq.
-
-Time complexity: O(1).
-*******************************************************************************/		
-void PQDestroy(pq_t *pq)
-{
-	assert(pq != NULL);
-	assert(pq->srt_list != NULL);
-
-	SrtListDestroy((srt_list_t *)pq->srt_list);	
-
-	free(pq); pq = NULL;
-}						
-
-/*******************************************************************************
-PQSize() - return the num of elements held in pq.
-
-Time complexity: O(n).
-*******************************************************************************/
-size_t PQSize(const pq_t *pq)
-{
-	assert(pq != NULL);
-	assert(pq->srt_list != NULL);
-	
-	return (SrtListSize((srt_list_t *)pq->srt_list));								
-}				
-	
-/*******************************************************************************
-PQIsempty() - return 1 if queue is empty, or 0 otherwise.
-
-Time complexity: O(1).
-*******************************************************************************/
-int PQIsempty(const pq_t *pq)
-{
-	assert(pq != NULL);
-	assert(pq->srt_list != NULL);
-	
-	return (SrtListIsEmpty((srt_list_t *)pq->srt_list));								
-}	
-	
-	
-/*******************************************************************************
-PQEnqueue() - Enqueue a new element according to its priority into the queue.
-			- returns 0 on sucess or 1 on failure
-
-Time complexity: O(n).
-*******************************************************************************/
-int PQEnqueue(pq_t *pq, void *data)
-{
-	assert(pq != NULL);
-	assert(pq->srt_list != NULL);
-	
-	return ((NULL == SrtListInsert((srt_list_t *)pq->srt_list, data).info));									
-}		
-
-/*******************************************************************************
-PQDequeue() - removes the next element form the queue and returns its data.
-
-Time complexity: O(1).
-*******************************************************************************/
-void *PQDequeue(pq_t *pq)
-{
-	assert(pq != NULL);
-	assert(pq->srt_list != NULL);	
-	
-	return (SrtListPopFront(pq->srt_list)) ;								
-}
-
-
-/*******************************************************************************
-PQPeek() - Returns the next element's data.
-
-Time complexity: O(1).
-*******************************************************************************/
-void *PQPeek(pq_t *pq)
-{						
-	assert(pq != NULL);
-	assert(pq->srt_list != NULL);
-	
-	return (SrtListGetData(SrtListBegin(pq->srt_list)));								
-}	
-	
-	
-	
-/*******************************************************************************
-PQClear() - Clears all elements from the queue.
-
-Time complexity: O(n).
-*******************************************************************************/	
-void PQClear(pq_t *pq)
-{	
-	assert(pq != NULL);
-	assert(pq->srt_list != NULL);
-	
-	while (0 == SrtListIsSameIter(SrtListBegin(pq->srt_list), 
-								  SrtListEnd(pq->srt_list)))
-	{
-		PQDequeue(pq);
-	}	
-}	
-
-/*******************************************************************************
-PQRemove() - find a spesific element according to params, and return its data.
-			 If didn't find anything returns NULL.
-
-Time complexity: O(n).
-*******************************************************************************/
-void *PQRemove(pq_t *pq, const void *to_find, void *params,											
-				int (*is_match)(const void *data,									
-				const void *to_find,					
-				void *params))
-{
-	srt_list_iter_t to_remove =  {0};
-	void *data = NULL;	
-	
-	assert(pq != NULL);
-	assert(pq->srt_list != NULL);
-	assert(is_match != NULL);
-
-	/* search "to_find" element in the queue */
-	to_remove = SrtListFindIf(SrtListBegin(pq->srt_list),
-							  SrtListEnd(pq->srt_list),	
-							  to_find, 
-							  params, 
-							  is_match);	
-
-
-
-	if (0 == (SrtListIsSameIter(to_remove, SrtListEnd(pq->srt_list))))
-	{
-		/* get data of "to_find" element */
-		data = SrtListGetData(to_remove);									
-		SrtListRemove(to_remove);									
-	}
-
-	return (data);
-}
-		
-								
-								
-
-								
-								
+#include <stddef.h> /* for size_t */
+#include <stdlib.h> /* for malloc */
+#include <assert.h> /* for assert */
+
+#include "pq.h"
+#include "dyn_vec.h"
+
+/* The queue is a binary min-heap (by is_before) of data pointers,
+   held in a dyn_vec: the children of index i are 2i + 1 and 2i + 2. */
+
+struct pq
+{
+	dyn_vec_t *heap;
+	void *params;
+	int (*is_before)(const void *data1, const void *data2, void *params);
+};
+
+/*******************************************************************************
+HeapItems() - helper function - the array of the data pointers in the heap.
+*******************************************************************************/
+static void **HeapItems(const pq_t *pq)
+{
+	return ((void **)DynVecGetItemAddress(pq->heap, 0));
+}
+
+/*******************************************************************************
+SiftUp() - helper function - moves the item at index up while it is before
+		   its parent.
+
+Time complexity: O(log n).
+*******************************************************************************/
+static void SiftUp(const pq_t *pq, void **items, size_t index)
+{
+	void *data = items[index];
+
+	while (index > 0)
+	{
+		size_t parent = (index - 1) / 2;
+
+		if (0 == pq->is_before(data, items[parent], pq->params))
+		{
+			break;
+		}
+
+		items[index] = items[parent];
+		index = parent;
+	}
+
+	items[index] = data;
+}
+
+/*******************************************************************************
+SiftDown() - helper function - moves the item at index down while one of its
+			 children is before it, in a heap of size items.
+
+Time complexity: O(log n).
+*******************************************************************************/
+static void SiftDown(const pq_t *pq, void **items, size_t size, size_t index)
+{
+	void *data = items[index];
+	size_t child = 0;
+
+	while ((child = (2 * index) + 1) < size)
+	{
+		if ((child + 1 < size) &&
+			(1 == pq->is_before(items[child + 1], items[child], pq->params)))
+		{
+			++child;
+		}
+
+		if (0 == pq->is_before(items[child], data, pq->params))
+		{
+			break;
+		}
+
+		items[index] = items[child];
+		index = child;
+	}
+
+	items[index] = data;
+}
+
+/*******************************************************************************
+Heapify() - helper function - builds the heap bottom-up, sifting down every
+			parent from the last one.
+
+Time complexity: O(n).
+*******************************************************************************/
+static void Heapify(const pq_t *pq)
+{
+	void **items = HeapItems(pq);
+	size_t size = DynVecSize(pq->heap);
+	size_t i = size / 2;
+
+	while (i > 0)
+	{
+		--i;
+		SiftDown(pq, items, size, i);
+	}
+}
+
+/*******************************************************************************
+FloorLog2() - helper function.
+*******************************************************************************/
+static size_t FloorLog2(size_t n)
+{
+	size_t res = 0;
+
+	while (n > 1)
+	{
+		n >>= 1;
+		++res;
+	}
+
+	return (res);
+}
+
+/*******************************************************************************
+PQCreate() - creates a priority queue and returns a pointer to it.
+*******************************************************************************/
+pq_t *PQCreate (void *params, int(*is_before)(const void *data1,
+											  const void *data2,
+											  void *params))
+{
+	pq_t *res = NULL;
+
+	assert(is_before != NULL);
+
+	res = (pq_t *)malloc(sizeof(*res));
+	if (NULL == res)
+	{
+		return (NULL);
+	}
+
+	res->heap = DynVecCreate(sizeof(void *), 1);
+	if (NULL == res->heap)
+	{
+		free(res); res = NULL;
+		return (NULL);
+	}
+
+	DynVecClear(res->heap);
+	res->params = params;
+	res->is_before = is_before;
+
+	return (res);
+}
+
+/*******************************************************************************
+PQCreateFrom() - creates a priority queue of the n elements of array
+				 (array is not changed), and returns a pointer to it.
+
+Time complexity: O(n).
+*******************************************************************************/
+pq_t *PQCreateFrom(void *params, int(*is_before)(const void *data1,
+												 const void *data2,
+												 void *params),
+				   void **array, size_t n)
+{
+	pq_t *res = NULL;
+
+	assert((array != NULL) || (0 == n));
+
+	res = PQCreate(params, is_before);
+	if ((NULL == res) || (0 == n))
+	{
+		return (res);
+	}
+
+	if (0 != DynVecPushBackN(res->heap, array, n))
+	{
+		PQDestroy(res); res = NULL;
+		return (NULL);
+	}
+
+	Heapify(res);
+
+	return (res);
+}
+
+/*******************************************************************************
+PQDestroy() - frees the pq (not the elements).
+
+Time complexity: O(1).
+*******************************************************************************/
+void PQDestroy(pq_t *pq)
+{
+	assert(pq != NULL);
+	assert(pq->heap != NULL);
+
+	DynVecDestroy(pq->heap);
+
+	free(pq); pq = NULL;
+}
+
+/*******************************************************************************
+PQSize() - return the num of elements held in pq.
+
+Time complexity: O(1).
+*******************************************************************************/
+size_t PQSize(const pq_t *pq)
+{
+	assert(pq != NULL);
+	assert(pq->heap != NULL);
+
+	return (DynVecSize(pq->heap));
+}
+
+/*******************************************************************************
+PQIsempty() - return 1 if queue is empty, or 0 otherwise.
+
+Time complexity: O(1).
+*******************************************************************************/
+int PQIsempty(const pq_t *pq)
+{
+	assert(pq != NULL);
+	assert(pq->heap != NULL);
+
+	return (0 == DynVecSize(pq->heap));
+}
+
+/*******************************************************************************
+PQEnqueue() - Enqueue a new element according to its priority into the queue.
+			- returns 0 on sucess or 1 on failure
+
+Time complexity: O(log n).
+*******************************************************************************/
+int PQEnqueue(pq_t *pq, void *data)
+{
+	assert(pq != NULL);
+	assert(pq->heap != NULL);
+
+	if (0 != DynVecPushBack(pq->heap, &data))
+	{
+		return (1);
+	}
+
+	SiftUp(pq, HeapItems(pq), DynVecSize(pq->heap) - 1);
+
+	return (0);
+}
+
+/*******************************************************************************
+PQEnqueueBatch() - Enqueues the n elements of items.
+				   A batch which is large to the queue is appended and the
+				   whole heap is rebuilt bottom-up, a small one is sifted up
+				   element by element.
+				 - returns 0 on sucess or 1 on failure (the queue is unchanged)
+
+Time complexity: O(min(n log(n + size), n + size)).
+*******************************************************************************/
+int PQEnqueueBatch(pq_t *pq, void **items, size_t n)
+{
+	size_t size = 0;
+	size_t i = 0;
+
+	assert(pq != NULL);
+	assert(pq->heap != NULL);
+	assert((items != NULL) || (0 == n));
+
+	if (0 == n)
+	{
+		return (0);
+	}
+
+	size = DynVecSize(pq->heap);
+	if (0 != DynVecPushBackN(pq->heap, items, n))
+	{
+		return (1);
+	}
+
+	/* a rebuild costs about 2 compares for every element in the heap */
+	if (n * FloorLog2(size + n) > 2 * (size + n))
+	{
+		Heapify(pq);
+	}
+	else
+	{
+		void **heap_items = HeapItems(pq);
+
+		for (i = size; i < size + n; ++i)
+		{
+			SiftUp(pq, heap_items, i);
+		}
+	}
+
+	return (0);
+}
+
+/*******************************************************************************
+PQMeld() - moves all the elements of src to dest, src becomes empty.
+		   The heap arrays are swapped if src is the larger, so the smaller
+		   one is enqueued into the larger one as a batch.
+		 - returns 0 on sucess or 1 on failure (both are unchanged)
+
+Time complexity: O(min(m log(n + m), n + m)), m - the size of the smaller.
+*******************************************************************************/
+int PQMeld(pq_t *dest, pq_t *src)
+{
+	dyn_vec_t *hold = NULL;
+
+	assert(dest != NULL);
+	assert(src != NULL);
+	assert(dest != src);
+	assert(dest->is_before == src->is_before);
+
+	if (DynVecSize(src->heap) > DynVecSize(dest->heap))
+	{
+		hold = dest->heap;
+		dest->heap = src->heap;
+		src->heap = hold;
+	}
+
+	if (0 != PQEnqueueBatch(dest, HeapItems(src), DynVecSize(src->heap)))
+	{
+		if (NULL != hold)
+		{
+			src->heap = dest->heap;
+			dest->heap = hold;
+		}
+
+		return (1);
+	}
+
+	DynVecClear(src->heap);
+
+	return (0);
+}
+
+/*******************************************************************************
+PQDequeue() - removes the next element form the queue and returns its data.
+			  returns NULL if the queue is empty.
+
+Time complexity: O(log n).
+*******************************************************************************/
+void *PQDequeue(pq_t *pq)
+{
+	void **items = NULL;
+	void *data = NULL;
+	size_t size = 0;
+
+	assert(pq != NULL);
+	assert(pq->heap != NULL);
+
+	size = DynVecSize(pq->heap);
+	if (0 == size)
+	{
+		return (NULL);
+	}
+
+	items = HeapItems(pq);
+	data = items[0];
+	items[0] = items[size - 1];
+	DynVecPopBack(pq->heap);
+
+	/* PopBack may shrink the vec */
+	if (size > 1)
+	{
+		SiftDown(pq, HeapItems(pq), size - 1, 0);
+	}
+
+	return (data);
+}
+
+/*******************************************************************************
+PQDequeueBatch() - removes up to k next elements from the queue into out,
+				   in their order, and returns the num of elements removed.
+
+Time complexity: O(k log n).
+*******************************************************************************/
+size_t PQDequeueBatch(pq_t *pq, void **out, size_t k)
+{
+	void **items = NULL;
+	size_t size = 0;
+	size_t i = 0;
+
+	assert(pq != NULL);
+	assert(pq->heap != NULL);
+	assert((out != NULL) || (0 == k));
+
+	size = DynVecSize(pq->heap);
+	if (k > size)
+	{
+		k = size;
+	}
+
+	/* the heap shrinks in place, the vec is cut once at the end */
+	items = HeapItems(pq);
+	for (i = 0; i < k; ++i)
+	{
+		out[i] = items[0];
+		--size;
+		items[0] = items[size];
+		SiftDown(pq, items, size, 0);
+	}
+
+	DynVecResize(pq->heap, size);
+
+	return (k);
+}
+
+/*******************************************************************************
+PQPeek() - Returns the next element's data, or NULL if the queue is empty.
+
+Time complexity: O(1).
+*******************************************************************************/
+void *PQPeek(pq_t *pq)
+{
+	assert(pq != NULL);
+	assert(pq->heap != NULL);
+
+	if (0 == DynVecSize(pq->heap))
+	{
+		return (NULL);
+	}
+
+	return (HeapItems(pq)[0]);
+}
+
+/*******************************************************************************
+PQClear() - Clears all elements from the queue.
+
+Time complexity: O(1).
+*******************************************************************************/
+void PQClear(pq_t *pq)
+{
+	assert(pq != NULL);
+	assert(pq->heap != NULL);
+
+	DynVecClear(pq->heap);
+}
+
+/*******************************************************************************
+PQRemove() - find a spesific element according to params, and return its data.
+			 If didn't find anything returns NULL.
+			 The last element takes its place, and is sifted up or down.
+
+Time complexity: O(n).
+*******************************************************************************/
+void *PQRemove(pq_t *pq, const void *to_find, void *params,
+				int (*is_match)(const void *data,
+				const void *to_find,
+				void *params))
+{
+	void **items = NULL;
+	void *data = NULL;
+	size_t size = 0;
+	size_t i = 0;
+
+	assert(pq != NULL);
+	assert(pq->heap != NULL);
+	assert(is_match != NULL);
+
+	size = DynVecSize(pq->heap);
+	items = HeapItems(pq);
+
+	/* search "to_find" element in the queue */
+	for (i = 0; (i < size) && (0 == is_match(items[i], to_find, params)); ++i)
+	{
+		/* empty */
+	}
+
+	if (i == size)
+	{
+		return (NULL);
+	}
+
+	data = items[i];
+	items[i] = items[size - 1];
+	DynVecPopBack(pq->heap);
+	--size;
+
+	if (i < size)
+	{
+		items = HeapItems(pq);
+		SiftUp(pq, items, i);
+		SiftDown(pq, items, size, i);
+	}
+
+	return (data);
+}
+
+/*******************************************************************************
+PQRemoveIf() - removes every element for which should_remove returns 1
+			   (should_remove may free it). The kept elements are moved
+			   forward in the heap array in place, and heapified.
+			   returns the num of elements removed.
+
+Time complexity: O(n).
+*******************************************************************************/
+size_t PQRemoveIf(pq_t *pq, void *params,
+				  int (*should_remove)(void *data, void *params))
+{
+	void **items = NULL;
+	size_t size = 0;
+	size_t num_kept = 0;
+	size_t i = 0;
+
+	assert(pq != NULL);
+	assert(pq->heap != NULL);
+	assert(should_remove != NULL);
+
+	size = DynVecSize(pq->heap);
+	items = HeapItems(pq);
+
+	for (i = 0; i < size; ++i)
+	{
+		if (1 != should_remove(items[i], params))
+		{
+			items[num_kept] = items[i];
+			++num_kept;
+		}
+	}
+
+	if (num_kept < size)
+	{
+		/* shrinking never fails */
+		DynVecResize(pq->heap, num_kept);
+		Heapify(pq);
+	}
+
+	return (size - num_kept);
+}
@@ -1,33 +1,60 @@
-#include <stddef.h> /* size_t */														
-#include "srt_list.h" /* size_t */						
-														
-typedef struct pq pq_t;	
-								
-pq_t *PQCreate(void *params,											
-			int (*is_before)(const void *data1,								
-			const void *data2,				
+#ifndef PQ_H_
+#define PQ_H_
+
+#include <stddef.h> /* size_t */
+
+typedef struct pq pq_t;
+
+pq_t *PQCreate(void *params,
+			int (*is_before)(const void *data1,
+			const void *data2,
 			void *params));
-			
-			
+
+/* A queue of the n elements of array (array is not changed),
+   or NULL on failure. O(n) */
+pq_t *PQCreateFrom(void *params,
+			int (*is_before)(const void *data1,
+			const void *data2,
+			void *params),
+			void **array, size_t n);
+
 void PQDestroy(pq_t *pq);
 
 size_t PQSize(const pq_t *pq);
-									
-int PQIsempty(const pq_t *pq);	
-									
-int PQEnqueue(pq_t *pq, void *data);				
 
+int PQIsempty(const pq_t *pq);
+
+int PQEnqueue(pq_t *pq, void *data);
+
+/* returns 0 on success, 1 on failure (the queue is unchanged).
+   A large batch is heapified in O(n + size) */
+int PQEnqueueBatch(pq_t *pq, void **items, size_t n);
+
+/* moves all the elements of src to dest (both with the same is_before),
+   src becomes empty. returns 0 on success, 1 on failure (both are
+   unchanged). O(m + n) at most - pairing_heap.h melds in O(1) */
+int PQMeld(pq_t *dest, pq_t *src);
+
+/* NULL if the queue is empty */
 void *PQDequeue(pq_t *pq);
 
-void *PQPeek(pq_t *pq);	
-									
+/* removes up to k next elements into out, in order.
+   returns the num of elements removed */
+size_t PQDequeueBatch(pq_t *pq, void **out, size_t k);
+
+/* NULL if the queue is empty */
+void *PQPeek(pq_t *pq);
+
 void PQClear(pq_t *pq);
-						
-void *PQRemove(pq_t *pq, const void *to_find, void *params,											
-				int (*is_match)(const void *data,									
-				const void *to_find,					
+
+void *PQRemove(pq_t *pq, const void *to_find, void *params,
+				int (*is_match)(const void *data,
+				const void *to_find,
 				void *params));
-				
 
-	
+/* removes every element for which should_remove returns 1 (it may free
+   the element). returns the num of elements removed. O(n) */
+size_t PQRemoveIf(pq_t *pq, void *params,
+				int (*should_remove)(void *data, void *params));
 
+#endif /* PQ_H_ */
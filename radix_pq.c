@@ -0,0 +1,380 @@
+#include <stddef.h> /* for size_t */
+#include <stdlib.h> /* for malloc */
+#include <limits.h> /* for CHAR_BIT */
+#include <assert.h> /* for assert */
+
+#include "radix_pq.h"
+#include "dyn_vec.h"
+
+/* Bucket 0 holds the keys equal to last (the last dequeued key), and
+   bucket i > 0 the keys whose highest bit that differs from last is
+   bit i - 1. When bucket 0 is empty, the first non-empty bucket is
+   emptied into the lower ones around its least key, which becomes last.
+   Every element only moves down, at most once per bit. */
+
+#define RADIX_PQ_NUM_BUCKETS (sizeof(unsigned long) * CHAR_BIT + 1)
+
+typedef struct radix_pq_entry
+{
+	unsigned long key;
+	void *data;
+} radix_pq_entry_t;
+
+struct radix_pq
+{
+	void *params;
+	unsigned long (*get_key)(const void *data, void *params);
+	unsigned long last;
+	unsigned long last_dequeued;	/* last may stay behind it (Refill) */
+	size_t size;
+	dyn_vec_t *buckets[RADIX_PQ_NUM_BUCKETS];
+};
+
+/*******************************************************************************
+BucketIndex() - helper function - the bucket of key, for the current last.
+
+Time complexity: O(1).
+*******************************************************************************/
+static size_t BucketIndex(const radix_pq_t *pq, unsigned long key)
+{
+	unsigned long diff = key ^ pq->last;
+	size_t res = 0;
+
+	if (0 == diff)
+	{
+		return (0);
+	}
+
+#ifdef __GNUC__
+	res = (sizeof(unsigned long) * CHAR_BIT) - (size_t)__builtin_clzl(diff);
+#else
+	while (diff != 0)
+	{
+		diff >>= 1;
+		++res;
+	}
+#endif
+
+	return (res);
+}
+
+/*******************************************************************************
+Entries() - helper function - the entries of a bucket.
+*******************************************************************************/
+static radix_pq_entry_t *Entries(const dyn_vec_t *bucket)
+{
+	return ((radix_pq_entry_t *)DynVecGetItemAddress(bucket, 0));
+}
+
+/*******************************************************************************
+Refill() - helper function - if bucket 0 is empty, empties the first
+		   non-empty bucket into the lower ones around its least key.
+		   If there is no memory to move them, last is not changed, and
+		   the entry with the least key is swapped to the back of its
+		   bucket instead (the buckets stay valid around the old last,
+		   as every key is at least it).
+		   Returns the bucket with the least key at its back,
+		   or NULL if the queue is empty.
+
+Time complexity: O(log C) amortized.
+*******************************************************************************/
+static dyn_vec_t *Refill(radix_pq_t *pq)
+{
+	size_t needed[RADIX_PQ_NUM_BUCKETS] = {0};
+	dyn_vec_t *from = NULL;
+	radix_pq_entry_t *entries = NULL;
+	radix_pq_entry_t hold = {0};
+	unsigned long old_last = pq->last;
+	size_t size = 0;
+	size_t min_index = 0;
+	size_t i = 0;
+
+	if (0 != DynVecSize(pq->buckets[0]))
+	{
+		return (pq->buckets[0]);
+	}
+
+	if (0 == pq->size)
+	{
+		return (NULL);
+	}
+
+	for (i = 1; 0 == DynVecSize(pq->buckets[i]); ++i)
+	{
+		/* empty */
+	}
+
+	from = pq->buckets[i];
+	size = DynVecSize(from);
+	entries = Entries(from);
+	for (i = 1; i < size; ++i)
+	{
+		if (entries[i].key < entries[min_index].key)
+		{
+			min_index = i;
+		}
+	}
+
+	hold = entries[min_index];
+	entries[min_index] = entries[size - 1];
+	entries[size - 1] = hold;
+
+	/* make room first, so that no entry is lost half way */
+	pq->last = hold.key;
+	for (i = 0; i < size; ++i)
+	{
+		++needed[BucketIndex(pq, entries[i].key)];
+	}
+
+	for (i = 0; i < RADIX_PQ_NUM_BUCKETS; ++i)
+	{
+		size_t new_size = DynVecSize(pq->buckets[i]) + needed[i];
+
+		if ((DynVecCapacity(pq->buckets[i]) < new_size) &&
+			(0 != DynVecReserve(pq->buckets[i], new_size)))
+		{
+			pq->last = old_last;
+			return (from);
+		}
+	}
+
+	for (i = 0; i < size; ++i)
+	{
+		DynVecPushBack(pq->buckets[BucketIndex(pq, entries[i].key)],
+					   &entries[i]);
+	}
+
+	DynVecClear(from);
+
+	return (pq->buckets[0]);
+}
+
+/*******************************************************************************
+RadixPQCreate() - creates a radix pq and returns a pointer to it,
+				  or NULL on failure.
+*******************************************************************************/
+radix_pq_t *RadixPQCreate(void *params,
+						  unsigned long (*get_key)(const void *data,
+												   void *params))
+{
+	radix_pq_t *res = NULL;
+	size_t i = 0;
+
+	assert(get_key != NULL);
+
+	res = (radix_pq_t *)malloc(sizeof(*res));
+	if (NULL == res)
+	{
+		return (NULL);
+	}
+
+	for (i = 0; i < RADIX_PQ_NUM_BUCKETS; ++i)
+	{
+		res->buckets[i] = DynVecCreate(sizeof(radix_pq_entry_t), 1);
+		if (NULL == res->buckets[i])
+		{
+			while (i > 0)
+			{
+				--i;
+				DynVecDestroy(res->buckets[i]);
+			}
+
+			free(res); res = NULL;
+			return (NULL);
+		}
+
+		DynVecClear(res->buckets[i]);
+	}
+
+	res->params = params;
+	res->get_key = get_key;
+	res->last = 0;
+	res->last_dequeued = 0;
+	res->size = 0;
+
+	return (res);
+}
+
+/*******************************************************************************
+RadixPQDestroy() - frees the pq (not the elements).
+
+Time complexity: O(1).
+*******************************************************************************/
+void RadixPQDestroy(radix_pq_t *pq)
+{
+	size_t i = 0;
+
+	assert(pq != NULL);
+
+	for (i = 0; i < RADIX_PQ_NUM_BUCKETS; ++i)
+	{
+		DynVecDestroy(pq->buckets[i]);
+	}
+
+	free(pq); pq = NULL;
+}
+
+/*******************************************************************************
+RadixPQSize() - return the num of elements held in pq.
+
+Time complexity: O(1).
+*******************************************************************************/
+size_t RadixPQSize(const radix_pq_t *pq)
+{
+	assert(pq != NULL);
+
+	return (pq->size);
+}
+
+/*******************************************************************************
+RadixPQIsempty() - return 1 if queue is empty, or 0 otherwise.
+
+Time complexity: O(1).
+*******************************************************************************/
+int RadixPQIsempty(const radix_pq_t *pq)
+{
+	assert(pq != NULL);
+
+	return (0 == pq->size);
+}
+
+/*******************************************************************************
+RadixPQEnqueue() - Enqueue a new element according to its key.
+				 - returns 0 on sucess or 1 on failure, or if its key is
+				   less than the last dequeued key.
+
+Time complexity: O(1).
+*******************************************************************************/
+int RadixPQEnqueue(radix_pq_t *pq, void *data)
+{
+	radix_pq_entry_t entry = {0};
+
+	assert(pq != NULL);
+
+	entry.key = pq->get_key(data, pq->params);
+	entry.data = data;
+	if (entry.key < pq->last_dequeued)
+	{
+		return (1);
+	}
+
+	if (0 != DynVecPushBack(pq->buckets[BucketIndex(pq, entry.key)], &entry))
+	{
+		return (1);
+	}
+
+	++pq->size;
+
+	return (0);
+}
+
+/*******************************************************************************
+RadixPQDequeue() - removes the element with the least key from the queue and
+				   returns its data. returns NULL if the queue is empty.
+
+Time complexity: O(log C) amortized.
+*******************************************************************************/
+void *RadixPQDequeue(radix_pq_t *pq)
+{
+	dyn_vec_t *bucket = NULL;
+	void *data = NULL;
+
+	assert(pq != NULL);
+
+	bucket = Refill(pq);
+	if (NULL == bucket)
+	{
+		return (NULL);
+	}
+
+	data = Entries(bucket)[DynVecSize(bucket) - 1].data;
+	pq->last_dequeued = Entries(bucket)[DynVecSize(bucket) - 1].key;
+	DynVecPopBack(bucket);
+	--pq->size;
+
+	return (data);
+}
+
+/*******************************************************************************
+RadixPQPeek() - Returns the data of the element with the least key,
+				or NULL if the queue is empty.
+
+Time complexity: O(log C) amortized.
+*******************************************************************************/
+void *RadixPQPeek(radix_pq_t *pq)
+{
+	dyn_vec_t *bucket = NULL;
+
+	assert(pq != NULL);
+
+	bucket = Refill(pq);
+	if (NULL == bucket)
+	{
+		return (NULL);
+	}
+
+	return (Entries(bucket)[DynVecSize(bucket) - 1].data);
+}
+
+/*******************************************************************************
+RadixPQClear() - Clears all elements from the queue. The keys may start
+				 over from any value.
+
+Time complexity: O(1).
+*******************************************************************************/
+void RadixPQClear(radix_pq_t *pq)
+{
+	size_t i = 0;
+
+	assert(pq != NULL);
+
+	for (i = 0; i < RADIX_PQ_NUM_BUCKETS; ++i)
+	{
+		DynVecClear(pq->buckets[i]);
+	}
+
+	pq->last = 0;
+	pq->last_dequeued = 0;
+	pq->size = 0;
+}
+
+/*******************************************************************************
+RadixPQRemove() - find a spesific element according to params, and return
+				  its data. If didn't find anything returns NULL.
+
+Time complexity: O(n).
+*******************************************************************************/
+void *RadixPQRemove(radix_pq_t *pq, const void *to_find, void *params,
+					int (*is_match)(const void *data,
+					const void *to_find,
+					void *params))
+{
+	size_t i = 0;
+	size_t j = 0;
+
+	assert(pq != NULL);
+	assert(is_match != NULL);
+
+	for (i = 0; i < RADIX_PQ_NUM_BUCKETS; ++i)
+	{
+		radix_pq_entry_t *entries = Entries(pq->buckets[i]);
+		size_t size = DynVecSize(pq->buckets[i]);
+
+		for (j = 0; j < size; ++j)
+		{
+			if (1 == is_match(entries[j].data, to_find, params))
+			{
+				void *data = entries[j].data;
+
+				/* the order inside a bucket doesn't matter */
+				entries[j] = entries[size - 1];
+				DynVecPopBack(pq->buckets[i]);
+				--pq->size;
+
+				return (data);
+			}
+		}
+	}
+
+	return (NULL);
+}
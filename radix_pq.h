@@ -0,0 +1,40 @@
+#ifndef RADIX_PQ_H_
+#define RADIX_PQ_H_
+
+#include <stddef.h> /* size_t */
+
+/* Monotone priority queue of integer keys (a radix heap): the key of a new
+   element must not be less than the key of the last dequeued element,
+   as with timestamps in an event simulation, or distances in Dijkstra.
+   The element with the least key is dequeued first.
+   Enqueue is O(1), Dequeue is O(log C) amortized (C - the key range). */
+
+typedef struct radix_pq radix_pq_t;
+
+radix_pq_t *RadixPQCreate(void *params,
+			unsigned long (*get_key)(const void *data, void *params));
+
+void RadixPQDestroy(radix_pq_t *pq);
+
+size_t RadixPQSize(const radix_pq_t *pq);
+
+int RadixPQIsempty(const radix_pq_t *pq);
+
+/* returns 0 on success, 1 on failure, or if the key of data is less
+   than the key of the last dequeued element */
+int RadixPQEnqueue(radix_pq_t *pq, void *data);
+
+/* NULL if the queue is empty */
+void *RadixPQDequeue(radix_pq_t *pq);
+
+/* NULL if the queue is empty */
+void *RadixPQPeek(radix_pq_t *pq);
+
+void RadixPQClear(radix_pq_t *pq);
+
+void *RadixPQRemove(radix_pq_t *pq, const void *to_find, void *params,
+				int (*is_match)(const void *data,
+				const void *to_find,
+				void *params));
+
+#endif /* RADIX_PQ_H_ */
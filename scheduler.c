@@ -1,21 +1,268 @@
+#define _POSIX_C_SOURCE 200112L /* for clock_gettime */
 #include <assert.h> 	/* for assert */							
 #include <stddef.h> 	/* for size_t */							
 #include <stdlib.h>		/* for malloc*/		
 #include <unistd.h> 	/* for sleep */	
+#include <time.h>		/* for clock_gettime */
 
 #include "scheduler.h"
 #include "scheduler_task.h"
 #include "pq.h"
-
+#include "hash_map.h"
+#include "hdr_hist.h"
+
+#define SCHEDULER_COMPACT_MIN (64)	/* cancelled entries before a compaction */
+#define SCHEDULER_NSEC_PER_SEC (1000000000UL)
+
+/* The queue holds entries. A removed task is only marked cancelled (found by
+   its uid in the index, and taken out of it), and it is destroyed when it
+   is dequeued, or when the cancelled entries are more than the live ones
+   and the queue is rebuilt without them.
+   A rescheduled task gets a new entry (and task) under the same uid. */
+typedef struct scheduler_entry
+{
+	uuid_t uid;
+	task_t *task;
+	int (*func)(void *params);
+	void *params;
+	unsigned long interval_sec;
+	uint64_t due_ns;		/* monotonic time of the next run */
+	scheduler_task_stats_t *stats;	/* NULL until the first tracked run */
+	int is_cancelled;
+} scheduler_entry_t;
 
 struct scheduler
 {							
 	pq_t	*tasks;
-	task_t	*current_task;
+	scheduler_entry_t *current_task;
+	hash_map_t *index;		/* uid -> entry of the live tasks */
+	size_t	num_cancelled;	/* still in the queue */
 	int 	is_running;		/* flag, hold 1 if scheduler is running */
 	int 	is_remove;		/* flag, hold 1 if task remove itself */
+	int 	is_task_stats;	/* flag, hold 1 if per task stats are kept */
+	unsigned long stats_seq;	/* odd while stats are written */
+	scheduler_stats_t stats;
 };
 
+/*******************************************************************************
+Helper function - the monotonic time in nanoseconds.
+*******************************************************************************/
+static uint64_t NowNs(void)
+{
+	struct timespec now;
+
+	clock_gettime(CLOCK_MONOTONIC, &now);
+
+	return (((uint64_t)now.tv_sec * SCHEDULER_NSEC_PER_SEC) +
+			(uint64_t)now.tv_nsec);
+}
+
+/*******************************************************************************
+Helper functions - uid keys of the index.
+*******************************************************************************/
+static size_t UidHash(const void *key, void *params)
+{
+	(void)params;
+
+	return (UuidHash(*(const uuid_t *)key));
+}
+
+static int UidIsEqual(const void *key1, const void *key2, void *params)
+{
+	(void)params;
+
+	return (UuidIsequal(*(const uuid_t *)key1, *(const uuid_t *)key2));
+}
+
+/*******************************************************************************
+Helper function - takes the uid of entry out of the index, if the index still
+maps it to entry (and not to a new entry of a reschedule).
+*******************************************************************************/
+static void Unindex(scheduler_t *scheduler, scheduler_entry_t *entry)
+{
+	if (HashMapFind(scheduler->index, &entry->uid) == entry)
+	{
+		HashMapRemove(scheduler->index, &entry->uid);
+	}
+}
+
+/*******************************************************************************
+Helper function - creates an entry of a new task.
+Returns the entry, or NULL on failure.
+*******************************************************************************/
+static scheduler_entry_t *EntryCreate(int (*func)(void *params), void *params,
+									  unsigned long interval_sec)
+{
+	scheduler_entry_t *new_entry = NULL;
+
+	new_entry = (scheduler_entry_t *)malloc(sizeof(*new_entry));
+	if (NULL == new_entry)
+	{
+		return (NULL);
+	}
+
+	new_entry->task = SchedulerTaskCreate(func, params, interval_sec);
+	if (NULL == new_entry->task)
+	{
+		free(new_entry); new_entry = NULL;
+		return (NULL);
+	}
+
+	new_entry->uid = SchedulerTaskGetId(new_entry->task);
+	new_entry->func = func;
+	new_entry->params = params;
+	new_entry->interval_sec = interval_sec;
+	new_entry->due_ns = NowNs() + ((uint64_t)interval_sec *
+								   SCHEDULER_NSEC_PER_SEC);
+	new_entry->stats = NULL;
+	new_entry->is_cancelled = 0;
+
+	return (new_entry);
+}
+
+/*******************************************************************************
+Helper functions - the stats are written only by the thread of the scheduler,
+between StatsBegin and StatsEnd (a seqlock), and read by SchedulerGetStats
+from any thread, which retries while the sequence is odd or changed.
+*******************************************************************************/
+static void StatsBegin(scheduler_t *scheduler)
+{
+	__atomic_store_n(&scheduler->stats_seq, scheduler->stats_seq + 1,
+					 __ATOMIC_RELAXED);
+	__atomic_thread_fence(__ATOMIC_RELEASE);
+}
+
+static void StatsEnd(scheduler_t *scheduler)
+{
+	__atomic_store_n(&scheduler->stats_seq, scheduler->stats_seq + 1,
+					 __ATOMIC_RELEASE);
+}
+
+/*******************************************************************************
+Helper function - the num of live tasks changed.
+*******************************************************************************/
+static void StatsDepth(scheduler_t *scheduler)
+{
+	size_t depth = HashMapSize(scheduler->index);
+
+	StatsBegin(scheduler);
+	scheduler->stats.depth = depth;
+	if (depth > scheduler->stats.max_depth)
+	{
+		scheduler->stats.max_depth = depth;
+	}
+	StatsEnd(scheduler);
+}
+
+/*******************************************************************************
+Helper function - counts a run of entry, of lateness_ns and exec_ns.
+The per task stats of a task which rescheduled itself go to its new entry.
+*******************************************************************************/
+static void StatsRun(scheduler_t *scheduler, scheduler_entry_t *entry,
+					 uint64_t lateness_ns, uint64_t exec_ns)
+{
+	if (1 == scheduler->is_remove)
+	{
+		scheduler_entry_t *new_entry = (scheduler_entry_t *)HashMapFind(
+												scheduler->index, &entry->uid);
+
+		if (NULL != new_entry)
+		{
+			entry = new_entry;
+		}
+	}
+
+	if ((1 == scheduler->is_task_stats) && (NULL == entry->stats))
+	{
+		entry->stats = (scheduler_task_stats_t *)malloc(sizeof(*entry->stats));
+		if (NULL != entry->stats)
+		{
+			HdrHistInit(&entry->stats->lateness_ns);
+			HdrHistInit(&entry->stats->exec_ns);
+		}
+	}
+
+	if (NULL != entry->stats)
+	{
+		HdrHistRecord(&entry->stats->lateness_ns, lateness_ns);
+		HdrHistRecord(&entry->stats->exec_ns, exec_ns);
+	}
+
+	StatsBegin(scheduler);
+	HdrHistRecord(&scheduler->stats.lateness_ns, lateness_ns);
+	HdrHistRecord(&scheduler->stats.exec_ns, exec_ns);
+	HdrHistRecord(&scheduler->stats.depth_hist, scheduler->stats.depth);
+	++scheduler->stats.num_runs;
+	StatsEnd(scheduler);
+}
+
+/*******************************************************************************
+Helper function - counts a failed re-enqueue.
+*******************************************************************************/
+static void StatsEnqueueFailure(scheduler_t *scheduler)
+{
+	StatsBegin(scheduler);
+	++scheduler->stats.num_enqueue_failures;
+	StatsEnd(scheduler);
+}
+
+/*******************************************************************************
+Helper function - the order of the queue, by the tasks of the entries.
+*******************************************************************************/
+static int EntryIsBefore(const void *data1, const void *data2, void *params)
+{
+	return (SchedulerTaskIsBefore(((const scheduler_entry_t *)data1)->task,
+								  ((const scheduler_entry_t *)data2)->task,
+								  params));
+}
+
+/*******************************************************************************
+Helper function - destroys the task of entry and entry.
+*******************************************************************************/
+static void EntryDestroy(scheduler_entry_t *entry)
+{
+	SchedulerTaskDestroy(entry->task);
+	free(entry->stats); entry->stats = NULL;
+	free(entry); entry = NULL;
+}
+
+/*******************************************************************************
+Helper function - destroys entry if it is cancelled (for PQRemoveIf).
+*******************************************************************************/
+static int DestroyIfCancelled(void *data, void *params)
+{
+	scheduler_entry_t *entry = (scheduler_entry_t *)data;
+
+	(void)params;
+
+	if (1 == entry->is_cancelled)
+	{
+		EntryDestroy(entry);
+		return (1);
+	}
+
+	return (0);
+}
+
+/*******************************************************************************
+Helper function - rebuilds the queue without the cancelled entries, when they
+are more than the live ones, so every compaction follows at least as many
+removes as the entries it drops.
+
+Time complexity: O(n).
+*******************************************************************************/
+static void Compact(scheduler_t *scheduler)
+{
+	if ((scheduler->num_cancelled < SCHEDULER_COMPACT_MIN) ||
+		(2 * scheduler->num_cancelled <= PQSize(scheduler->tasks)))
+	{
+		return;
+	}
+
+	PQRemoveIf(scheduler->tasks, NULL, DestroyIfCancelled);
+	scheduler->num_cancelled = 0;
+}
+
 /*******************************************************************************
 returns pointer to new scheduler, or NULL on faliure
 *******************************************************************************/				
@@ -29,17 +276,30 @@ scheduler_t *SchedulerCreate(void)
 	}
 	
 	/* Allocate memory for pq of tasks */
-	new_scheduler->tasks = PQCreate(NULL, SchedulerTaskIsBefore);
+	new_scheduler->tasks = PQCreate(NULL, EntryIsBefore);
 	if (NULL == new_scheduler->tasks)
 	{
 		free(new_scheduler); new_scheduler = NULL;
 		return (NULL);
 	}
+
+	new_scheduler->index = HashMapCreate(sizeof(uuid_t), NULL, UidHash,
+										 UidIsEqual);
+	if (NULL == new_scheduler->index)
+	{
+		PQDestroy(new_scheduler->tasks);
+		free(new_scheduler); new_scheduler = NULL;
+		return (NULL);
+	}
 	
 	/* assignment struct's fields */
+	new_scheduler->num_cancelled = 0;
 	new_scheduler->current_task = NULL;
 	new_scheduler->is_running = 0;
 	new_scheduler->is_remove = 0;
+	new_scheduler->is_task_stats = 0;
+	new_scheduler->stats_seq = 0;
+	SchedulerResetStats(new_scheduler);
 	
 	return (new_scheduler);
 }
@@ -58,6 +318,7 @@ void SchedulerDestroy(scheduler_t *scheduler)
 	
 	/* free pq */	
 	PQDestroy(scheduler->tasks);
+	HashMapDestroy(scheduler->index); scheduler->index = NULL;
 
 	/* free scheduler */		
 	free(scheduler); scheduler = NULL;
@@ -76,69 +337,168 @@ int SchedulerIsEmpty(const scheduler_t *scheduler)
 {
 	assert(scheduler != NULL);
 
-	/* check the current task too */
-	return ((PQIsempty(scheduler->tasks)) && (NULL == scheduler->current_task));
+	/* the current task is counted too, the cancelled ones are not */
+	return (HashMapIsEmpty(scheduler->index));
 }
 
 /*******************************************************************************
 Inserts a new element according to its priority into the scheduler.
 
-Time complexity: O(n).
+Time complexity: O(log n).
 *******************************************************************************/
 uuid_t SchedulerAdd(scheduler_t *scheduler,
 					int(*func)(void *params),
 					void *params, 
 					unsigned long interval_sec)
 {
-	task_t *new_task = NULL;
+	scheduler_entry_t *new_entry = NULL;
 	
 	assert(scheduler != NULL);
 	assert(func != NULL);
 	
-	new_task = SchedulerTaskCreate(func, params, interval_sec);
-	if (NULL == new_task)
+	new_entry = EntryCreate(func, params, interval_sec);
+	if (NULL == new_entry)
 	{
 		return (UuidGetInvalidID());
 	}
 	
-	if (PQEnqueue(scheduler->tasks, new_task) != 0)
+	if (0 != HashMapInsert(scheduler->index, &new_entry->uid, new_entry))
 	{
-		free(new_task); new_task = NULL;
+		EntryDestroy(new_entry); new_entry = NULL;
 
 		return (UuidGetInvalidID());
 	}
+
+	if (PQEnqueue(scheduler->tasks, new_entry) != 0)
+	{
+		HashMapRemove(scheduler->index, &new_entry->uid);
+		EntryDestroy(new_entry); new_entry = NULL;
+
+		return (UuidGetInvalidID());
+	}
+
+	StatsDepth(scheduler);
 	
-	return (SchedulerTaskGetId(new_task));
+	return (new_entry->uid);
 }
 
 /*******************************************************************************
-Removes a specific task according the uid, and returns 1.
-If didn't find returns 0.
+Removes a specific task according the uid, and returns 0.
+If didn't find returns 1.
+The task is marked cancelled, and is destroyed later (lazily).
 
-Time complexity: O(n).
+Time complexity: O(1) amortized.
 *******************************************************************************/
 int SchedulerRemove(scheduler_t *scheduler, uuid_t uid)
 {
-	void *to_remove = NULL;
+	scheduler_entry_t *to_remove = NULL;
 
 	assert(scheduler != NULL);
 
+	to_remove = (scheduler_entry_t *)HashMapFind(scheduler->index, &uid);
+	if (NULL == to_remove)
+	{
+		return (1);
+	}
+
 	/* if current_task try to remove itself */
-	if ((scheduler->current_task != NULL) && 
-		(SchedulerTaskIsMatch(scheduler->current_task, &uid, NULL)))
+	if (to_remove == scheduler->current_task)
 	{
 		scheduler->is_remove = 1;
 		return (0);
 	}
 
-	to_remove = PQRemove(scheduler->tasks, &uid, NULL, SchedulerTaskIsMatch);
-	if (NULL == to_remove)
+	HashMapRemove(scheduler->index, &uid);
+	to_remove->is_cancelled = 1;
+	++scheduler->num_cancelled;
+	Compact(scheduler);
+	StatsDepth(scheduler);
+	
+	return (0);
+}
+
+/*******************************************************************************
+Changes the interval of the task of uid: the task is replaced by a new task
+of the new interval (from now), under the same uid, which keeps its per task
+stats. Returns 0 on success, or 1 if didn't find or on failure (the task is
+unchanged).
+A task may reschedule itself, its new task replaces it after it runs.
+
+Time complexity: O(log n).
+*******************************************************************************/
+int SchedulerReschedule(scheduler_t *scheduler, uuid_t uid,
+						unsigned long new_interval_sec)
+{
+	scheduler_entry_t *old_entry = NULL;
+	scheduler_entry_t *new_entry = NULL;
+
+	assert(scheduler != NULL);
+
+	old_entry = (scheduler_entry_t *)HashMapFind(scheduler->index, &uid);
+	if (NULL == old_entry)
 	{
 		return (1);
 	}
-	
-	SchedulerTaskDestroy(to_remove);
-	
+
+	new_entry = EntryCreate(old_entry->func, old_entry->params,
+							new_interval_sec);
+	if (NULL == new_entry)
+	{
+		return (1);
+	}
+
+	new_entry->uid = uid;
+	if (PQEnqueue(scheduler->tasks, new_entry) != 0)
+	{
+		EntryDestroy(new_entry); new_entry = NULL;
+		return (1);
+	}
+
+	/* the key is in the index, so only its data is replaced */
+	HashMapInsert(scheduler->index, &uid, new_entry);
+
+	/* the per task stats stay with the uid */
+	new_entry->stats = old_entry->stats;
+	old_entry->stats = NULL;
+
+	if (old_entry == scheduler->current_task)
+	{
+		scheduler->is_remove = 1;
+	}
+	else
+	{
+		old_entry->is_cancelled = 1;
+		++scheduler->num_cancelled;
+		Compact(scheduler);
+	}
+
+	return (0);
+}
+
+/*******************************************************************************
+Returns 0 if the task of uid is scheduled, and its interval in interval_sec
+(if not NULL), or 1 if didn't find.
+
+Time complexity: O(1) expected.
+*******************************************************************************/
+int SchedulerQuery(const scheduler_t *scheduler, uuid_t uid,
+				   unsigned long *interval_sec)
+{
+	scheduler_entry_t *entry = NULL;
+
+	assert(scheduler != NULL);
+
+	entry = (scheduler_entry_t *)HashMapFind(scheduler->index, &uid);
+	if (NULL == entry)
+	{
+		return (1);
+	}
+
+	if (NULL != interval_sec)
+	{
+		*interval_sec = entry->interval_sec;
+	}
+
 	return (0);
 }
 
@@ -173,27 +533,66 @@ int SchedulerRun(scheduler_t *scheduler)
 	/* run tasks until stop function or until scheduler is empty */
 	while ((SchedulerIsEmpty(scheduler) != 1) && (1 == scheduler->is_running))
 	{	
-		scheduler->current_task = (task_t *)PQDequeue(scheduler->tasks);
+		scheduler_entry_t *entry = (scheduler_entry_t *)PQDequeue(scheduler->tasks);
+		uint64_t lateness_ns = 0;
+		uint64_t start_ns = 0;
+		int status = 0;
+
+		/* a removed task is dropped when it reaches the top */
+		if (1 == entry->is_cancelled)
+		{
+			EntryDestroy(entry);
+			--scheduler->num_cancelled;
+			continue;
+		}
+
+		scheduler->current_task = entry;
 		
+		start_ns = NowNs();
+		lateness_ns = (start_ns > entry->due_ns) ?
+					  (start_ns - entry->due_ns) : 0;
+		status = SchedulerTaskRun(entry->task);
+		StatsRun(scheduler, entry, lateness_ns, NowNs() - start_ns);
+
 		/* if rturen from SchedulerTaskRun is not error, 
 		and the task is not trying to removes itself */
-		if (0 == (SchedulerTaskRun(scheduler->current_task)) && 
-			(0 == scheduler->is_remove))
+		if ((0 == status) && (0 == scheduler->is_remove))
 		{		
-			SchedulerTaskUpdate(scheduler->current_task);
+			SchedulerTaskUpdate(entry->task);
 
-			if (1 == PQEnqueue(scheduler->tasks, scheduler->current_task))
+			/* from the due time, not from now, so lateness adds up when
+			   the runs fall behind. A task of no interval is due again
+			   right away */
+			if (0 == entry->interval_sec)
 			{
-				SchedulerTaskDestroy(scheduler->current_task);
+				entry->due_ns = NowNs();
+			}
+			else
+			{
+				entry->due_ns += (uint64_t)entry->interval_sec *
+								 SCHEDULER_NSEC_PER_SEC;
+			}
+
+			if (1 == PQEnqueue(scheduler->tasks, entry))
+			{
+				StatsEnqueueFailure(scheduler);
+				Unindex(scheduler, entry);
+				EntryDestroy(entry);
+				scheduler->current_task = NULL;
+				scheduler->is_running = 0;
+				StatsDepth(scheduler);
 				return (1);
 			}
 		}
 		else
 		{
-			SchedulerTaskDestroy(scheduler->current_task);
+			Unindex(scheduler, entry);
+			EntryDestroy(entry);
+			StatsDepth(scheduler);
 		}
 		
 		scheduler->current_task = NULL;
+		scheduler->is_remove = 0;
 	}
 	
 	scheduler->is_running = 0;
@@ -213,10 +612,104 @@ void SchedulerClear(scheduler_t *scheduler)
 
 	while ((PQIsempty(scheduler->tasks)) != 1)
 	{
-		task_t *task = (task_t*)PQDequeue(scheduler->tasks);
+		scheduler_entry_t *entry = (scheduler_entry_t *)PQDequeue(scheduler->tasks);
+
+		if (0 == entry->is_cancelled)
+		{
+			Unindex(scheduler, entry);
+		}
 
-		SchedulerTaskDestroy(task);		
+		EntryDestroy(entry);
 	}
+
+	scheduler->num_cancelled = 0;
+	StatsDepth(scheduler);
+}
+
+/*******************************************************************************
+Keeps stats of every task (from its next run) if is_on is 1, or stops
+keeping them (the kept ones stay) if 0.
+
+Time complexity: O(1).
+*******************************************************************************/
+void SchedulerSetTaskStats(scheduler_t *scheduler, int is_on)
+{
+	assert(scheduler != NULL);
+
+	scheduler->is_task_stats = is_on;
+}
+
+/*******************************************************************************
+Copies the stats into stats. Safe from any thread, while the scheduler runs:
+retries while the thread of the scheduler writes the stats.
+
+Time complexity: O(num of buckets).
+*******************************************************************************/
+void SchedulerGetStats(const scheduler_t *scheduler, scheduler_stats_t *stats)
+{
+	unsigned long seq = 0;
+
+	assert(scheduler != NULL);
+	assert(stats != NULL);
+
+	do
+	{
+		while (0 != ((seq = __atomic_load_n(&scheduler->stats_seq,
+											__ATOMIC_ACQUIRE)) & 1))
+		{
+		}
+
+		*stats = scheduler->stats;
+		__atomic_thread_fence(__ATOMIC_ACQUIRE);
+	}
+	while (seq != __atomic_load_n(&scheduler->stats_seq, __ATOMIC_RELAXED));
+}
+
+/*******************************************************************************
+Copies the stats of the task of uid into stats, and returns 0. Returns 1 if
+didn't find, or it has no stats (yet). From the thread of the scheduler only
+(a task may read its own stats).
+
+Time complexity: O(num of buckets).
+*******************************************************************************/
+int SchedulerGetTaskStats(const scheduler_t *scheduler, uuid_t uid,
+						  scheduler_task_stats_t *stats)
+{
+	scheduler_entry_t *entry = NULL;
+
+	assert(scheduler != NULL);
+	assert(stats != NULL);
+
+	entry = (scheduler_entry_t *)HashMapFind(scheduler->index, &uid);
+	if ((NULL == entry) || (NULL == entry->stats))
+	{
+		return (1);
+	}
+
+	*stats = *entry->stats;
+
+	return (0);
+}
+
+/*******************************************************************************
+Empties the global stats (the max depth starts from the depth).
+From the thread of the scheduler only.
+
+Time complexity: O(num of buckets).
+*******************************************************************************/
+void SchedulerResetStats(scheduler_t *scheduler)
+{
+	assert(scheduler != NULL);
+
+	StatsBegin(scheduler);
+	HdrHistInit(&scheduler->stats.lateness_ns);
+	HdrHistInit(&scheduler->stats.exec_ns);
+	HdrHistInit(&scheduler->stats.depth_hist);
+	scheduler->stats.num_runs = 0;
+	scheduler->stats.num_enqueue_failures = 0;
+	scheduler->stats.depth = HashMapSize(scheduler->index);
+	scheduler->stats.max_depth = scheduler->stats.depth;
+	StatsEnd(scheduler);
 }
 
 					
@@ -4,9 +4,30 @@
 #include <stddef.h> /* size_t */							
 							
 #include "uuid.h"
+#include "hdr_hist.h"
 						
 
 typedef struct scheduler scheduler_t;
+
+/* times in nanoseconds, of CLOCK_MONOTONIC. lateness - the start of a run
+   after its due time (the interval after it was added, then every interval
+   from there) */
+typedef struct scheduler_task_stats
+{
+	hdr_hist_t lateness_ns;
+	hdr_hist_t exec_ns;
+} scheduler_task_stats_t;
+
+typedef struct scheduler_stats
+{
+	hdr_hist_t lateness_ns;
+	hdr_hist_t exec_ns;
+	hdr_hist_t depth_hist;		/* the depth at every run */
+	size_t num_runs;
+	size_t num_enqueue_failures;	/* tasks lost to a failed re-enqueue */
+	size_t depth;				/* num of tasks */
+	size_t max_depth;
+} scheduler_stats_t;
 							
 scheduler_t *SchedulerCreate(void);							
 void SchedulerDestroy(scheduler_t *scheduler);							
@@ -17,11 +38,36 @@ uuid_t SchedulerAdd(scheduler_t *scheduler,
 					unsigned long interval_sec);
 							
 int SchedulerRemove(scheduler_t *scheduler, uuid_t uid);							
+
+/* the task of uid runs every new_interval_sec, from now (its stats are
+   kept). Returns 0 on success or 1 if not found or on failure */
+int SchedulerReschedule(scheduler_t *scheduler, uuid_t uid,
+						unsigned long new_interval_sec);
+
+/* Returns 0 if the task of uid is scheduled (and its interval in
+   interval_sec, if not NULL), or 1 if not found */
+int SchedulerQuery(const scheduler_t *scheduler, uuid_t uid,
+				   unsigned long *interval_sec);
+
 void SchedulerStop(scheduler_t *scheduler);							
 							
 /* Returns 0 on success or 1 on failure */							
 int SchedulerRun(scheduler_t *scheduler);							
 void SchedulerClear(scheduler_t *scheduler);							
+
+/* per task stats are kept only while set (they cost two histograms a task) */
+void SchedulerSetTaskStats(scheduler_t *scheduler, int is_on);
+
+/* may be called from any thread, also while the scheduler runs */
+void SchedulerGetStats(const scheduler_t *scheduler, scheduler_stats_t *stats);
+
+/* from the thread of the scheduler only.
+   Returns 0 on success or 1 if not found or no stats were kept */
+int SchedulerGetTaskStats(const scheduler_t *scheduler, uuid_t uid,
+						  scheduler_task_stats_t *stats);
+
+/* from the thread of the scheduler only */
+void SchedulerResetStats(scheduler_t *scheduler);
 							
 #endif /* SCHEDULER_H_ */
 
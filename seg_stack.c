@@ -0,0 +1,197 @@
+#include <string.h> /* for memcpy */
+#include <stdlib.h> /* for malloc */
+#include <assert.h> /* for assert */
+#include "seg_stack.h"
+
+typedef struct stack_segment stack_segment_t;
+
+struct stack_segment
+{
+	stack_segment_t *prev;
+	char start[1];
+};
+
+struct seg_stack
+{
+	char *top;
+	char *segment_start;			/* start of the elements of current */
+	char *segment_end;				/* end of the elements of current */
+	stack_segment_t *current;
+	stack_segment_t *spare;			/* kept for the next push at the edge */
+	size_t size_of_element;
+	size_t elements_per_segment;
+	size_t num_of_elements;
+};
+
+
+/****************************************************************
+Helper function - allocates a segment of elements_per_segment
+elements, return NULL if the allocation is fail
+****************************************************************/
+static stack_segment_t *SegmentCreate(const seg_stack_t *stack)
+{
+	return ((stack_segment_t *)malloc(sizeof(stack_segment_t) + 
+						stack->size_of_element * stack->elements_per_segment));
+}
+
+/****************************************************************
+Helper function - makes segment the current segment.
+top is set to the start of the segment.
+****************************************************************/
+static void SetCurrent(seg_stack_t *stack, stack_segment_t *segment)
+{
+	stack->current = segment;
+	stack->segment_start = segment->start;
+	stack->segment_end = segment->start + 
+						 stack->size_of_element * stack->elements_per_segment;
+	stack->top = stack->segment_start;
+}
+
+
+/****************************************************************
+Resived element_size and elements_per_segment, and return pointer 
+to Stack, if the allocation is fail return NULL
+****************************************************************/
+seg_stack_t *SegStackCreate(size_t element_size, size_t elements_per_segment)
+{
+	seg_stack_t *new_stack = NULL;
+	stack_segment_t *first = NULL;
+
+	assert(0 != element_size);
+	assert(0 != elements_per_segment);
+
+	new_stack = (seg_stack_t *)malloc(sizeof(*new_stack));
+	if (NULL == new_stack)
+	{
+		return (NULL);
+	}
+
+	new_stack->size_of_element = element_size;
+	new_stack->elements_per_segment = elements_per_segment;
+	new_stack->num_of_elements = 0;
+	new_stack->spare = NULL;
+
+	first = SegmentCreate(new_stack);
+	if (NULL == first)
+	{
+		free(new_stack); new_stack = NULL;
+		return (NULL);
+	}
+
+	first->prev = NULL;
+	SetCurrent(new_stack, first);
+
+	return (new_stack);
+}
+
+
+/****************************************************************
+Destroy the Stack and free the memory of all the segments
+****************************************************************/
+void SegStackDestroy(seg_stack_t *stack)
+{
+	stack_segment_t *segment = NULL;
+
+	assert(NULL != stack);
+
+	segment = stack->current;
+	while (NULL != segment)
+	{
+		stack_segment_t *prev = segment->prev;
+
+		free(segment);
+		segment = prev;
+	}
+
+	free(stack->spare); stack->spare = NULL;
+	free(stack); stack = NULL;
+}
+
+
+/****************************************************************
+Inserts an object at the top of the Stack.
+When the current segment is full, the spare segment (or a new 
+one) is chained on top of it - the old elements are not copied.
+return 0 if sucsses, and -1 if the allocation is fail.
+Time complexity: O(1).
+****************************************************************/
+int SegStackPush(seg_stack_t *stack, const void *element)
+{
+	assert(NULL != element);
+	assert(NULL != stack);
+
+	if (stack->top == stack->segment_end)
+	{
+		stack_segment_t *segment = stack->spare;
+
+		if (NULL == segment)
+		{
+			segment = SegmentCreate(stack);
+			if (NULL == segment)
+			{
+				return (-1);
+			}
+		}
+
+		stack->spare = NULL;
+		segment->prev = stack->current;
+		SetCurrent(stack, segment);
+	}
+
+	memcpy(stack->top, element, stack->size_of_element);
+	stack->top += stack->size_of_element;
+	++stack->num_of_elements;
+
+	return (0);
+}
+
+
+/****************************************************************
+Removes the object at the top of the Stack.
+A segment that becomes empty is kept as the spare (the previous
+spare is freed), so push/pop across the edge doesn't allocate.
+Time complexity: O(1).
+****************************************************************/
+void SegStackPop(seg_stack_t *stack)
+{
+	assert(NULL != stack);
+	assert(0 != stack->num_of_elements);
+
+	stack->top -= stack->size_of_element;
+	--stack->num_of_elements;
+
+	if ((stack->top == stack->segment_start) && 
+		(NULL != stack->current->prev))
+	{
+		stack_segment_t *empty = stack->current;
+
+		free(stack->spare);
+		stack->spare = empty;
+
+		SetCurrent(stack, empty->prev);
+		stack->top = stack->segment_end;
+	}
+}
+
+
+/****************************************************************
+Returns the object at the top of the Stack without removing it.
+****************************************************************/
+void *SegStackPeek(const seg_stack_t *stack)
+{
+	assert(NULL != stack);
+	assert(0 != stack->num_of_elements);
+
+	return (stack->top - stack->size_of_element);
+}
+
+
+/****************************************************************
+Return the num of the element in the Stack
+****************************************************************/
+size_t SegStackSize(const seg_stack_t *stack)
+{
+	assert(NULL != stack);
+
+	return (stack->num_of_elements);
+}
@@ -0,0 +1,19 @@
+#ifndef SEG_STACK_H_
+#define SEG_STACK_H_
+#include <stddef.h> /* size_t */
+
+/* Stack that grows by chaining segments of elements_per_segment elements.
+   Elements never move, so pointers from SegStackPeek stay valid
+   until the element is popped. */
+
+typedef struct seg_stack seg_stack_t;
+
+seg_stack_t *SegStackCreate(size_t element_size, size_t elements_per_segment);
+void SegStackDestroy(seg_stack_t *stack);
+/* return 0 if sucsses, and -1 if the allocation of a segment fails */
+int SegStackPush(seg_stack_t *stack, const void *element);
+void SegStackPop(seg_stack_t *stack);
+void *SegStackPeek(const seg_stack_t *stack);
+size_t SegStackSize(const seg_stack_t *stack);
+
+#endif /* SEG_STACK_H_ */
@@ -294,3 +294,339 @@ slist_node_t *SListFindIntersection(slist_node_t *head1, slist_node_t *head2)
 	return (NULL);
 }
 						
+
+/*******************************************************************************
+Returns the first node that exists in both slist1 and slist2
+Returns NULL if didnt find anything
+Each pointer walks its own slist and then switches to the head of the other,
+so both pointers cover n1 + n2 nodes and meet at the intersection (or at NULL)
+without computing the sizes first.
+Time complexity: O(n1 + n2).
+*******************************************************************************/
+slist_node_t *SListFindIntersectionTwoPtr(slist_node_t *head1,
+										  slist_node_t *head2)
+{
+	slist_node_t *runner1 = head1;
+	slist_node_t *runner2 = head2;
+
+	assert(SListHasLoop(head1) != 1);
+	assert(SListHasLoop(head2) != 1);
+
+	while (runner1 != runner2)
+	{
+		runner1 = (NULL == runner1) ? head2 : runner1->next;
+		runner2 = (NULL == runner2) ? head1 : runner2->next;
+	}
+
+	return (runner1);
+}
+
+/*******************************************************************************
+Helper functions for SListFindIntersectionMany.
+Open addressing (linear probing) set of node addresses.
+The number of slots is a power of two, at least twice the number of nodes.
+*******************************************************************************/
+static size_t SListAddrHash(const slist_node_t *node, size_t mask)
+{
+	size_t key = (size_t)node;
+
+	/* nodes are malloc-aligned, mix the high bits into the low ones */
+	key ^= key >> 17;
+	key *= (size_t)0x9E3779B1UL;
+	key ^= key >> 29;
+
+	return (key & mask);
+}
+
+static void SListAddrSetInsert(const slist_node_t **slots, size_t mask,
+							   const slist_node_t *node)
+{
+	size_t i = SListAddrHash(node, mask);
+
+	while (slots[i] != NULL)
+	{
+		i = (i + 1) & mask;
+	}
+
+	slots[i] = node;
+}
+
+static int SListAddrSetHas(const slist_node_t **slots, size_t mask,
+						   const slist_node_t *node)
+{
+	size_t i = SListAddrHash(node, mask);
+
+	while (slots[i] != NULL)
+	{
+		if (slots[i] == node)
+		{
+			return (1);
+		}
+		i = (i + 1) & mask;
+	}
+
+	return (0);
+}
+
+/*******************************************************************************
+Finds the intersection of head with each of others[i], into results[i].
+The nodes of head are hashed once, then every other slist is walked only
+until its first node that belongs to head.
+Returns 0 on success or 1 on allocation failure.
+Time complexity: O(n + total length of the walked prefixes).
+*******************************************************************************/
+int SListFindIntersectionMany(slist_node_t *head,
+							  slist_node_t **others,
+							  size_t num_others,
+							  slist_node_t **results)
+{
+	const slist_node_t **slots = NULL;
+	const slist_node_t *node = NULL;
+	size_t num_slots = 2;
+	size_t size = 0;
+	size_t i = 0;
+
+	assert(SListHasLoop(head) != 1);
+	assert((others != NULL) || (0 == num_others));
+	assert((results != NULL) || (0 == num_others));
+
+	size = SListSize(head);
+	while (num_slots < (size * 2))
+	{
+		num_slots *= 2;
+	}
+
+	slots = (const slist_node_t **)calloc(num_slots, sizeof(*slots));
+	if (NULL == slots)
+	{
+		return (1);
+	}
+
+	for (node = head; node != NULL; node = node->next)
+	{
+		SListAddrSetInsert(slots, num_slots - 1, node);
+	}
+
+	for (i = 0; i < num_others; ++i)
+	{
+		slist_node_t *other = others[i];
+
+		assert(SListHasLoop(other) != 1);
+
+		while ((other != NULL) &&
+			   (0 == SListAddrSetHas(slots, num_slots - 1, other)))
+		{
+			other = other->next;
+		}
+
+		results[i] = other;
+	}
+
+	free(slots); slots = NULL;
+
+	return (0);
+}
+
+/*******************************************************************************
+Helper function for SListSort.
+Cuts the slist after "count" nodes, and returns the head of the rest.
+Time complexity: O(count).
+*******************************************************************************/
+static slist_node_t *SListCut(slist_node_t *head, size_t count)
+{
+	slist_node_t *rest = NULL;
+
+	while ((head != NULL) && (count > 1))
+	{
+		head = head->next;
+		--count;
+	}
+
+	if (NULL == head)
+	{
+		return (NULL);
+	}
+
+	rest = head->next;
+	head->next = NULL;
+
+	return (rest);
+}
+
+/*******************************************************************************
+Helper function for SListSort.
+Merges the sorted runs "left" and "right" after "tail",
+and returns the last node of the merged run.
+On equal data the node of "left" comes first, so the sort is stable.
+Time complexity: O(n).
+*******************************************************************************/
+static slist_node_t *SListMergeRuns(slist_node_t *tail,
+									slist_node_t *left,
+									slist_node_t *right,
+									void *params,
+									int (*is_before)(const void *data1,
+													 const void *data2,
+													 void *params))
+{
+	while ((left != NULL) && (right != NULL))
+	{
+		if (1 == is_before(right->data, left->data, params))
+		{
+			tail->next = right;
+			right = right->next;
+		}
+		else
+		{
+			tail->next = left;
+			left = left->next;
+		}
+
+		tail = tail->next;
+	}
+
+	tail->next = (left != NULL) ? left : right;
+
+	while (tail->next != NULL)
+	{
+		tail = tail->next;
+	}
+
+	return (tail);
+}
+
+/*******************************************************************************
+Sorts the slist by is_before (bottom-up merge sort), and returns the new head.
+The nodes are relinked in place - no allocation, O(1) extra space.
+Time complexity: O(n log n).
+*******************************************************************************/
+slist_node_t *SListSort(slist_node_t *head,
+						void *params,
+						int (*is_before)(const void *data1,
+										 const void *data2,
+										 void *params))
+{
+	slist_node_t dummy = {0};
+	size_t size = 0;
+	size_t width = 0;
+
+	assert(is_before != NULL);
+	assert(SListHasLoop(head) != 1);
+
+	size = SListSize(head);
+	dummy.next = head;
+
+	/* merge runs of width 1, 2, 4 ... until one run holds the whole slist */
+	for (width = 1; width < size; width *= 2)
+	{
+		slist_node_t *tail = &dummy;
+		slist_node_t *rest = dummy.next;
+
+		while (rest != NULL)
+		{
+			slist_node_t *left = rest;
+			slist_node_t *right = SListCut(left, width);
+
+			rest = SListCut(right, width);
+			tail = SListMergeRuns(tail, left, right, params, is_before);
+		}
+	}
+
+	return (dummy.next);
+}
+
+/*******************************************************************************
+Prefetch helpers.
+The walk keeps a second pointer SLIST_PREFETCH_DISTANCE nodes ahead and
+prefetches that node's next and data, so the cache misses of the coming nodes
+overlap with the work on the current one.
+*******************************************************************************/
+#define SLIST_PREFETCH_DISTANCE (4)
+
+#if defined(__GNUC__)
+#define SLIST_PREFETCH(addr) __builtin_prefetch((addr), 0, 1)
+#else
+#define SLIST_PREFETCH(addr) ((void)(addr))
+#endif
+
+static const slist_node_t *SListPrefetchAhead(const slist_node_t *ahead)
+{
+	if (ahead != NULL)
+	{
+		SLIST_PREFETCH(ahead->next);
+		SLIST_PREFETCH(ahead->data);
+		ahead = ahead->next;
+	}
+
+	return (ahead);
+}
+
+static const slist_node_t *SListPrefetchStart(const slist_node_t *head)
+{
+	size_t i = 0;
+
+	for (i = 0; (i < SLIST_PREFETCH_DISTANCE) && (head != NULL); ++i)
+	{
+		head = SListPrefetchAhead(head);
+	}
+
+	return (head);
+}
+
+/*******************************************************************************
+Same as SListFind, with prefetching of the nodes ahead.
+Returns NULL if didnt find anything
+Time complexity: O(n).
+*******************************************************************************/
+slist_node_t *SListFindPrefetch(slist_node_t *head, const void* to_find,
+								void *params,
+								int(*is_match)
+								(const void *node_data,
+								 const void *to_find,
+								 void *params))
+{
+	const slist_node_t *ahead = NULL;
+
+	assert(is_match != NULL);
+	assert(SListHasLoop(head) != 1);
+
+	ahead = SListPrefetchStart(head);
+
+	while (head != NULL)
+	{
+		if (1 == is_match(head->data, to_find, params))
+		{
+			return (head);
+		}
+		head = head->next;
+		ahead = SListPrefetchAhead(ahead);
+	}
+
+	return (NULL);
+}
+
+/*******************************************************************************
+Same as SListForEach, with prefetching of the nodes ahead.
+when fails returns do_func's failure value and stops iterating
+Time complexity: O(n).
+*******************************************************************************/
+int SListForEachPrefetch(slist_node_t *head,
+						 int (*do_func)(void *params, void *data),
+						 void *params)
+{
+	const slist_node_t *ahead = NULL;
+	int res = 0;
+
+	assert(SListHasLoop(head) != 1);
+	assert(do_func != NULL);
+
+	ahead = SListPrefetchStart(head);
+
+	while ((head != NULL) && (0 == res))
+	{
+		res = do_func(params, head->data);
+		head = head->next;
+		ahead = SListPrefetchAhead(ahead);
+	}
+
+	return (res);
+}
@@ -42,6 +42,20 @@ size_t SListSize(const slist_node_t *head);
 						
 /* Returns NULL if didnt find anything */						
 slist_node_t *SListFindIntersection(slist_node_t *head1, slist_node_t *head2);						
+
+/* Returns NULL if didnt find anything. No size pre-walks */
+slist_node_t *SListFindIntersectionTwoPtr(slist_node_t *head1, slist_node_t *head2);
+
+/* results[i] gets the intersection of head and others[i] (or NULL)
+   Returns 0 on success or 1 on allocation failure */
+int SListFindIntersectionMany(slist_node_t *head, slist_node_t **others, size_t num_others, slist_node_t **results);
+
+/* Stable in-place merge sort, returns the new head. O(1) extra space */
+slist_node_t *SListSort(slist_node_t *head, void *params, int (*is_before)(const void *data1, const void *data2, void *params));
+
+/* Same as SListFind / SListForEach, but prefetch the nodes ahead of the walk */
+slist_node_t *SListFindPrefetch(slist_node_t *head, const void* to_find, void *params,   int (*is_match)(const void *node_data, const void *to_find, void *params));
+int SListForEachPrefetch(slist_node_t *head, int (*do_func)(void *params, void *data), void *params);
 		
 
 
@@ -0,0 +1,289 @@
+#include <stdlib.h> /* for malloc */
+#include <assert.h> /* for assert */
+#include <string.h> /* for memcpy */
+
+#include "soa_vec.h"
+
+#define SOA_VEC_DEFAULT_GROWTH_PERCENT (200)
+
+struct soa_vec
+{
+	size_t num_fields;
+	size_t size;
+	size_t num_items; /* capacity */
+	size_t growth_percent;
+	soa_field_t *fields;
+	char **columns;
+};
+
+/****************************************************************
+Resived the fields of the record and num_items, and return 
+pointer to an empty soa_vec with room for num_items records.
+if the allocation is fail return NULL
+****************************************************************/
+soa_vec_t *SoaVecCreate(const soa_field_t *fields, size_t num_fields, 
+						size_t num_items)
+{
+	soa_vec_t *new_vec = NULL;
+	size_t i = 0;
+
+	assert(fields != NULL);
+	assert(num_fields);
+	assert(num_items);
+
+	/* the struct, the fields and the column pointers in one block */
+	new_vec = (soa_vec_t *)malloc(sizeof(*new_vec) + 
+								  num_fields * sizeof(soa_field_t) +
+								  num_fields * sizeof(char *));
+	if (NULL == new_vec)
+	{
+		return (NULL);
+	}
+
+	new_vec->num_fields = num_fields;
+	new_vec->size = 0;
+	new_vec->num_items = num_items;
+	new_vec->growth_percent = SOA_VEC_DEFAULT_GROWTH_PERCENT;
+	new_vec->fields = (soa_field_t *)(new_vec + 1);
+	new_vec->columns = (char **)(new_vec->fields + num_fields);
+
+	memcpy(new_vec->fields, fields, num_fields * sizeof(soa_field_t));
+	
+	for (i = 0; i < num_fields; ++i)
+	{
+		assert(fields[i].size);
+
+		new_vec->columns[i] = (char *)malloc(num_items * fields[i].size);
+		if (NULL == new_vec->columns[i])
+		{
+			while (i > 0)
+			{
+				--i;
+				free(new_vec->columns[i]); new_vec->columns[i] = NULL;
+			}
+			free(new_vec); new_vec = NULL;
+
+			return (NULL);
+		}
+	}
+
+	return (new_vec);
+}
+
+/****************************************************************
+Destroy the soa_vec and free the memory
+****************************************************************/
+void SoaVecDestroy(soa_vec_t *vec)
+{
+	size_t i = 0;
+
+	assert(vec != NULL);
+
+	for (i = 0; i < vec->num_fields; ++i)
+	{
+		free(vec->columns[i]); vec->columns[i] = NULL;
+	}
+
+	free(vec); vec = NULL;
+}
+
+/****************************************************************
+Return the num of the records in the soa_vec
+****************************************************************/
+size_t SoaVecSize(const soa_vec_t *vec)
+{
+	assert(vec != NULL);
+
+	return (vec->size);
+}
+
+/****************************************************************
+return the capacity of soa_vec 
+****************************************************************/
+size_t SoaVecCapacity(const soa_vec_t *vec)
+{
+	assert(vec != NULL);
+
+	return (vec->num_items);
+}
+
+/****************************************************************
+return the num of the columns
+****************************************************************/
+size_t SoaVecNumFields(const soa_vec_t *vec)
+{
+	assert(vec != NULL);
+
+	return (vec->num_fields);
+}
+
+/****************************************************************
+resived an soa_vec and new_capacity, 
+and increase every column to new_capacity items.
+On failure the capacity doesn't change (some columns may be
+larger already, which is harmless).
+return 0 if sucsses, and 1 if fail.
+****************************************************************/
+int SoaVecReserve(soa_vec_t *vec, size_t new_capacity)
+{
+	size_t i = 0;
+
+	assert(vec != NULL);
+	assert(vec->num_items < new_capacity);
+
+	for (i = 0; i < vec->num_fields; ++i)
+	{
+		char *new_column = (char *)realloc(vec->columns[i], 
+										new_capacity * vec->fields[i].size);
+		if (NULL == new_column)
+		{
+			return (1);
+		}
+
+		vec->columns[i] = new_column;
+	}
+
+	vec->num_items = new_capacity;
+
+	return (0);
+}
+
+/****************************************************************
+set the growth factor of PushBack, in percent of the capacity
+(150 grows by 1.5, the default 200 doubles)
+****************************************************************/
+void SoaVecSetGrowthFactor(soa_vec_t *vec, size_t growth_percent)
+{
+	assert(vec != NULL);
+	assert(growth_percent > 100);
+
+	vec->growth_percent = growth_percent;
+}
+
+/****************************************************************
+Inserts a record at the top: every field goes to its column.
+return 0 if sucsses, and 1 if fail.
+****************************************************************/
+int SoaVecPushBack(soa_vec_t *vec, const void *record)
+{
+	size_t i = 0;
+
+	assert(vec != NULL);
+	assert(record != NULL);
+
+	if (vec->size == vec->num_items)
+	{
+		size_t new_capacity = 
+					vec->num_items / 100 * vec->growth_percent +
+					vec->num_items % 100 * vec->growth_percent / 100;
+
+		if (new_capacity <= vec->num_items)
+		{
+			new_capacity = vec->num_items + 1;
+		}
+
+		if (SoaVecReserve(vec, new_capacity))
+		{
+			return (1);
+		}
+	}
+
+	for (i = 0; i < vec->num_fields; ++i)
+	{
+		size_t field_size = vec->fields[i].size;
+
+		memcpy(vec->columns[i] + (vec->size * field_size),
+			   (const char *)record + vec->fields[i].offset, field_size);
+	}
+
+	++vec->size;
+
+	return (0);
+}
+
+/****************************************************************
+Removes the record at the top.
+****************************************************************/
+void SoaVecPopBack(soa_vec_t *vec)
+{
+	assert(vec != NULL);
+	assert(vec->size > 0);
+
+	--vec->size;
+}
+
+/****************************************************************
+Copies the fields of the record at index into record
+****************************************************************/
+void SoaVecGetRecord(const soa_vec_t *vec, size_t index, void *record)
+{
+	size_t i = 0;
+
+	assert(vec != NULL);
+	assert(record != NULL);
+	assert(index < vec->size);
+
+	for (i = 0; i < vec->num_fields; ++i)
+	{
+		size_t field_size = vec->fields[i].size;
+
+		memcpy((char *)record + vec->fields[i].offset,
+			   vec->columns[i] + (index * field_size), field_size);
+	}
+}
+
+/****************************************************************
+return the start of the column of field
+****************************************************************/
+void *SoaVecColumn(const soa_vec_t *vec, size_t field)
+{
+	assert(vec != NULL);
+	assert(field < vec->num_fields);
+
+	return (vec->columns[field]);
+}
+
+/****************************************************************
+return the address of the field of the record at index
+****************************************************************/
+void *SoaVecGetItemAddress(const soa_vec_t *vec, size_t field, size_t index)
+{
+	assert(vec != NULL);
+	assert(field < vec->num_fields);
+	assert(index < vec->num_items);
+
+	return (vec->columns[field] + (index * vec->fields[field].size));
+}
+
+/****************************************************************
+Operates do_func on every item of one column.
+returns do_func's non-zero value and stops iterating.
+Time complexity: O(n).
+****************************************************************/
+int SoaVecForEachInColumn(const soa_vec_t *vec, size_t field, void *params,
+						  int (*do_func)(void *item, void *params))
+{
+	char *item = NULL;
+	char *end = NULL;
+	size_t field_size = 0;
+
+	assert(vec != NULL);
+	assert(field < vec->num_fields);
+	assert(do_func != NULL);
+
+	field_size = vec->fields[field].size;
+	item = vec->columns[field];
+	end = item + (vec->size * field_size);
+
+	for (; item < end; item += field_size)
+	{
+		int res = do_func(item, params);
+
+		if (res != 0)
+		{
+			return (res);
+		}
+	}
+
+	return (0);
+}
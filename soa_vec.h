@@ -0,0 +1,45 @@
+#ifndef SOA_VEC_H
+#define SOA_VEC_H
+#include <stddef.h> /* size_t */
+
+/* Structure of arrays: one contiguous column per field of a record,
+   all the columns share the size and the capacity. */
+
+typedef struct soa_vec soa_vec_t;
+
+/* a field of the record - offsetof and sizeof */
+typedef struct soa_field
+{
+	size_t offset;
+	size_t size;
+} soa_field_t;
+
+/* empty vec with room for num_items records, or NULL */
+soa_vec_t *SoaVecCreate(const soa_field_t *fields, size_t num_fields, size_t num_items);
+void SoaVecDestroy(soa_vec_t *vec);
+size_t SoaVecSize(const soa_vec_t *vec);
+size_t SoaVecCapacity(const soa_vec_t *vec);
+size_t SoaVecNumFields(const soa_vec_t *vec);
+
+/* scatters the fields of record to the columns.
+   return 0 if sucsses, and 1 if fail */
+int SoaVecPushBack(soa_vec_t *vec, const void *record);
+void SoaVecPopBack(soa_vec_t *vec);
+
+/* gathers the fields of the record at index into record */
+void SoaVecGetRecord(const soa_vec_t *vec, size_t index, void *record);
+
+/* the column of field - SoaVecSize items, fields[field].size bytes each.
+   Invalidated by growth */
+void *SoaVecColumn(const soa_vec_t *vec, size_t field);
+void *SoaVecGetItemAddress(const soa_vec_t *vec, size_t field, size_t index);
+
+/* same policy as dyn_vec: explicit reserve, push grows by growth_percent */
+int SoaVecReserve(soa_vec_t *vec, size_t new_capacity);
+void SoaVecSetGrowthFactor(soa_vec_t *vec, size_t growth_percent);
+
+/* iterates over one column, returns the first non-zero value of do_func */
+int SoaVecForEachInColumn(const soa_vec_t *vec, size_t field, void *params,
+						  int (*do_func)(void *item, void *params));
+
+#endif /* SOA_VEC_H */
@@ -1,45 +1,656 @@
-#include <stddef.h> /* for size_t */	
-#include <stdlib.h> /* for malloc */	
-#include <assert.h> /* for assert */									
+#include <stddef.h> /* for size_t */
+#include <stdlib.h> /* for malloc */
+#include <string.h> /* for memcpy */
+#include <assert.h> /* for assert */
+
+#include "srt_list.h"
+#include "dyn_vec.h"
+#include "dyn_vec_algo.h" /* for DynVecSort */
+
+/* The sorted list is a skip list: every node is linked at level 0
+   (which is the whole list, in order) and at a random number of
+   levels above it, each level linked in both directions.
+   Iterators are nodes, so they stay valid until the node is removed.
+   Every link holds its span - the num of level 0 steps it skips - so
+   positions (ranks) are found in O(log n) like the data. */
+
+#define SRT_LIST_MAX_LEVEL (16) /* enough for 4^16 nodes */
+#define SRT_LIST_HINT_STEPS (32) /* a longer walk from a hint is a search */
+
+typedef struct srt_list_node srt_list_node_t;
+
+struct srt_list_link
+{
+	srt_list_node_t *next;
+	srt_list_node_t *prev;
+	size_t span;				/* rank of next - rank of this node */
+};
+
+struct srt_list_node
+{
+	void *data;
+	unsigned int height; /* num of links */
+	unsigned int is_pooled; /* part of a block of SrtListCreateFrom */
+	struct srt_list_link links[1];
+};
+
+/* the nodes of SrtListCreateFrom follow their block in one allocation.
+   The blocks are freed with the list which owns them */
+struct srt_list_block
+{
+	struct srt_list_block *next;
+	void *align; /* the nodes start on a pointer boundary */
+};
 
-#include "srt_list.h"			
-						
 struct srt_list
 {
 	void *params;
 	int (*is_before)(const void *data1,	const void *data2, void *params);
-	dlist_t *dlist;
-};								
+	srt_list_node_t *tail;		/* dummy, the end iterator */
+	size_t size;
+	size_t level;				/* num of levels in use */
+	unsigned long seed;			/* for the random heights */
+	struct srt_list_block *blocks;
+	srt_list_node_t *last_insert;	/* for the adaptive mode, or NULL */
+	int is_adaptive;
+	srt_list_node_t head;		/* dummy before begin (rank 0) - must be
+								   last, SRT_LIST_MAX_LEVEL links follow it.
+								   All the levels of it are kept, the unused
+								   ones link to the tail (rank size + 1) */
+};
+
+/*******************************************************************************
+NodeSize() - helper function - bytes of a node of height links.
+*******************************************************************************/
+static size_t NodeSize(size_t height)
+{
+	return (offsetof(srt_list_node_t, links) +
+			height * sizeof(struct srt_list_link));
+}
+
+/*******************************************************************************
+IterToNode() / NodeToIter() - helper functions.
+*******************************************************************************/
+static srt_list_node_t *IterToNode(srt_list_iter_t iter)
+{
+	return ((srt_list_node_t *)iter.info);
+}
+
+static srt_list_iter_t NodeToIter(srt_list_node_t *node)
+{
+	srt_list_iter_t res = {0};
+
+	res.info = (struct srt_list_iter_info *)node;
+
+	return (res);
+}
+
+/*******************************************************************************
+RandomHeight() - helper function - 1 + geometric(1/4) levels.
+
+Time complexity: O(1) expected.
+*******************************************************************************/
+static size_t RandomHeight(srt_list_t *srt_list)
+{
+	size_t height = 1;
+	unsigned long bits = 0;
+
+	/* xorshift32 */
+	srt_list->seed ^= (srt_list->seed << 13) & 0xFFFFFFFFUL;
+	srt_list->seed ^= srt_list->seed >> 17;
+	srt_list->seed ^= (srt_list->seed << 5) & 0xFFFFFFFFUL;
+
+	/* every pair of zero bits adds a level */
+	for (bits = srt_list->seed; 
+		 (0 == (bits & 3)) && (height < SRT_LIST_MAX_LEVEL); 
+		 bits >>= 2)
+	{
+		++height;
+	}
+
+	return (height);
+}
+
+/*******************************************************************************
+ListOfNode() - helper function - returns the srt_list that holds node.
+Walks back along the highest link of every node it passes, which is the
+search path in reverse, until the head dummy (embedded in the srt_list).
+
+Time complexity: O(log n) expected.
+*******************************************************************************/
+static srt_list_t *ListOfNode(srt_list_node_t *node)
+{
+	while (node->links[node->height - 1].prev != NULL)
+	{
+		node = node->links[node->height - 1].prev;
+	}
+
+	return ((srt_list_t *)((char *)node - offsetof(srt_list_t, head)));
+}
+
+/*******************************************************************************
+IsAhead() - helper function - returns 1 if the search for data goes on past
+			node_data: if node_data is before data, or for an upper search,
+			if data is not before node_data.
+*******************************************************************************/
+static int IsAhead(const srt_list_t *srt_list, const void *node_data,
+				   const void *data, int is_upper)
+{
+	if (1 == is_upper)
+	{
+		return (0 == srt_list->is_before(data, node_data, srt_list->params));
+	}
+
+	return (1 == srt_list->is_before(node_data, data, srt_list->params));
+}
+
+/*******************************************************************************
+FindPrevs() - helper function - fills update[i] with the last node on level i
+			  that is before data and rank[i] with its rank (on all levels),
+			  and returns the first node which is not before data.
+			  An upper search passes the nodes equal to data too.
+
+Time complexity: O(log n) expected.
+*******************************************************************************/
+static srt_list_node_t *FindPrevs(const srt_list_t *srt_list, const void *data,
+								  int is_upper, srt_list_node_t **update,
+								  size_t *rank)
+{
+	srt_list_node_t *node = (srt_list_node_t *)&srt_list->head;
+	size_t r = 0;
+	size_t i = SRT_LIST_MAX_LEVEL;
+
+	while (i > 0)
+	{
+		srt_list_node_t *next = NULL;
+
+		--i;
+		next = node->links[i].next;
+		while ((next != srt_list->tail) &&
+			   (1 == IsAhead(srt_list, next->data, data, is_upper)))
+		{
+			r += node->links[i].span;
+			node = next;
+			next = node->links[i].next;
+		}
+
+		update[i] = node;
+		rank[i] = r;
+	}
+
+	return (node->links[0].next);
+}
+
+/*******************************************************************************
+RanksToDists() - helper function - turns the ranks of FindPrevs into the
+				 distances of LinkNode (rank[0] - rank[i]).
+*******************************************************************************/
+static void RanksToDists(size_t *rank)
+{
+	size_t i = SRT_LIST_MAX_LEVEL;
+
+	/* rank[0] changes last */
+	while (i > 0)
+	{
+		--i;
+		rank[i] = rank[0] - rank[i];
+	}
+}
+
+/*******************************************************************************
+LinkNode() - helper function - links node after update[i] on every level of it,
+			 and counts it in the spans of the levels above it.
+			 dist[i] is the rank of update[0] - the rank of update[i].
+
+Time complexity: O(SRT_LIST_MAX_LEVEL).
+*******************************************************************************/
+static void LinkNode(srt_list_node_t *node, srt_list_node_t **update,
+					 const size_t *dist)
+{
+	size_t i = 0;
+
+	for (i = 0; i < node->height; ++i)
+	{
+		srt_list_node_t *next = update[i]->links[i].next;
+
+		node->links[i].prev = update[i];
+		node->links[i].next = next;
+		node->links[i].span = update[i]->links[i].span - dist[i];
+		update[i]->links[i].next = node;
+		update[i]->links[i].span = dist[i] + 1;
+		next->links[i].prev = node;
+	}
+
+	for (; i < SRT_LIST_MAX_LEVEL; ++i)
+	{
+		++update[i]->links[i].span;
+	}
+}
+
+/*******************************************************************************
+ClimbPrevs() - helper function - fills update[i] with the last node on level i
+			   up to prev (including it), and dist[i] with the rank of prev -
+			   the rank of it, on all levels.
+			   Walks back along the highest link of every node it passes.
+
+Time complexity: O(log n) expected.
+*******************************************************************************/
+static void ClimbPrevs(srt_list_node_t *prev, srt_list_node_t **update,
+					   size_t *dist)
+{
+	size_t d = 0;
+	size_t i = 0;
+
+	for (i = 0; i < SRT_LIST_MAX_LEVEL; ++i)
+	{
+		/* the head dummy has all the levels */
+		while (prev->height <= i)
+		{
+			srt_list_node_t *back = prev->links[prev->height - 1].prev;
+
+			d += back->links[prev->height - 1].span;
+			prev = back;
+		}
+
+		update[i] = prev;
+		dist[i] = d;
+	}
+}
+
+/*******************************************************************************
+WalkFrom() - helper function - walks on level 0 from node to the first node
+			 which is not before data, and returns it.
+			 Returns NULL if it is more than max_steps away.
+
+Time complexity: O(distance).
+*******************************************************************************/
+static srt_list_node_t *WalkFrom(const srt_list_t *srt_list,
+								 srt_list_node_t *node, const void *data,
+								 size_t max_steps)
+{
+	if (node == &srt_list->head)
+	{
+		node = node->links[0].next;
+	}
+
+	if ((node != srt_list->tail) &&
+		(1 == srt_list->is_before(node->data, data, srt_list->params)))
+	{
+		do
+		{
+			if (0 == max_steps)
+			{
+				return (NULL);
+			}
+
+			--max_steps;
+			node = node->links[0].next;
+		} while ((node != srt_list->tail) &&
+				 (1 == srt_list->is_before(node->data, data, srt_list->params)));
+
+		return (node);
+	}
+
+	/* back over the nodes equal to data too, the new node goes before them */
+	while ((node->links[0].prev != &srt_list->head) &&
+		   (0 == srt_list->is_before(node->links[0].prev->data, data,
+									 srt_list->params)))
+	{
+		if (0 == max_steps)
+		{
+			return (NULL);
+		}
+
+		--max_steps;
+		node = node->links[0].prev;
+	}
+
+	return (node);
+}
+
+/*******************************************************************************
+AdaptiveNext() - helper function - the first node which is not before data,
+				 if it is at one of the ends or near the last inserted node.
+				 Returns NULL otherwise.
+
+Time complexity: O(1).
+*******************************************************************************/
+static srt_list_node_t *AdaptiveNext(const srt_list_t *srt_list,
+									 const void *data)
+{
+	srt_list_node_t *front = srt_list->head.links[0].next;
+	srt_list_node_t *back = srt_list->tail->links[0].prev;
+
+	if (0 == srt_list->size)
+	{
+		return (srt_list->tail);
+	}
+
+	if (1 == srt_list->is_before(back->data, data, srt_list->params))
+	{
+		return (srt_list->tail);
+	}
+
+	if (0 == srt_list->is_before(front->data, data, srt_list->params))
+	{
+		return (front);
+	}
+
+	if (NULL != srt_list->last_insert)
+	{
+		return (WalkFrom(srt_list, srt_list->last_insert, data,
+						 SRT_LIST_HINT_STEPS));
+	}
+
+	return (NULL);
+}
+
+/*******************************************************************************
+InsertNode() - helper function - allocates a node for data and links it
+			   before next, or where a search finds if next is NULL.
+			   Returns the node, or NULL on faliure.
+
+Time complexity: O(log n) expected. With next, the place costs no compares.
+*******************************************************************************/
+static srt_list_node_t *InsertNode(srt_list_t *srt_list,
+								   srt_list_node_t *next, void *data)
+{
+	srt_list_node_t *update[SRT_LIST_MAX_LEVEL];
+	size_t dist[SRT_LIST_MAX_LEVEL];
+	srt_list_node_t *node = NULL;
+	size_t height = 0;
+
+	height = RandomHeight(srt_list);
+	node = (srt_list_node_t *)malloc(NodeSize(height));
+	if (NULL == node)
+	{
+		return (NULL);
+	}
+
+	if (NULL == next)
+	{
+		FindPrevs(srt_list, data, 0, update, dist);
+		RanksToDists(dist);
+	}
+	else
+	{
+		ClimbPrevs(next->links[0].prev, update, dist);
+	}
+
+	if (srt_list->level < height)
+	{
+		srt_list->level = height;
+	}
+
+	node->data = data;
+	node->height = (unsigned int)height;
+	node->is_pooled = 0;
+	LinkNode(node, update, dist);
+	++srt_list->size;
+	srt_list->last_insert = node;
+
+	return (node);
+}
+
+/*******************************************************************************
+RelinkLevels() - helper function - rebuilds the links and the spans of all the
+				 levels from the order of level 0, in one pass, keeping the
+				 height of every node.
+
+Time complexity: O(n).
+*******************************************************************************/
+static void RelinkLevels(srt_list_t *srt_list)
+{
+	srt_list_node_t *last[SRT_LIST_MAX_LEVEL];
+	size_t last_rank[SRT_LIST_MAX_LEVEL];
+	srt_list_node_t *node = NULL;
+	size_t rank = 0;
+	size_t i = 0;
+
+	for (i = 0; i < SRT_LIST_MAX_LEVEL; ++i)
+	{
+		last[i] = &srt_list->head;
+		last_rank[i] = 0;
+	}
+
+	srt_list->level = 1;
+	for (node = srt_list->head.links[0].next; node != srt_list->tail;
+		 node = node->links[0].next)
+	{
+		++rank;
+		for (i = 0; i < node->height; ++i)
+		{
+			last[i]->links[i].next = node;
+			last[i]->links[i].span = rank - last_rank[i];
+			node->links[i].prev = last[i];
+			last[i] = node;
+			last_rank[i] = rank;
+		}
+
+		if (node->height > srt_list->level)
+		{
+			srt_list->level = node->height;
+		}
+	}
+
+	for (i = 0; i < SRT_LIST_MAX_LEVEL; ++i)
+	{
+		last[i]->links[i].next = srt_list->tail;
+		last[i]->links[i].span = rank + 1 - last_rank[i];
+		srt_list->tail->links[i].prev = last[i];
+	}
+}
 
-	
 /*******************************************************************************
 SrtListCreate() - returns pointer to new srt_list, or NULL on faliure.
 
 *******************************************************************************/
-srt_list_t *SrtListCreate(void *params,	int (*is_before)(const void *data1,	
-														 const void *data2,	
+srt_list_t *SrtListCreate(void *params,	int (*is_before)(const void *data1,
+														 const void *data2,
 														 void *params))
-{	
+{
 	srt_list_t *new_srt_list = NULL;
-	
+	size_t i = 0;
+
 	assert(is_before != NULL);
 
-	new_srt_list = (srt_list_t *)malloc(sizeof(*new_srt_list));
+	new_srt_list = (srt_list_t *)malloc(offsetof(srt_list_t, head) +
+										NodeSize(SRT_LIST_MAX_LEVEL));
 	if (NULL == new_srt_list)
 	{
 		return (NULL);
-	}	
+	}
+
+	new_srt_list->tail = (srt_list_node_t *)malloc(
+											NodeSize(SRT_LIST_MAX_LEVEL));
+	if (NULL == new_srt_list->tail)
+	{
+		free(new_srt_list); new_srt_list = NULL;
+		return (NULL);
+	}
 
 	/* Initializing fields */
 	new_srt_list->params = params;
 	new_srt_list->is_before = is_before;
-	new_srt_list->dlist = DlistCreate();
-	if (NULL == new_srt_list->dlist)
+	new_srt_list->size = 0;
+	new_srt_list->level = 1;
+	new_srt_list->blocks = NULL;
+	new_srt_list->last_insert = NULL;
+	new_srt_list->is_adaptive = 0;
+	new_srt_list->seed = ((unsigned long)(size_t)new_srt_list &
+						  0xFFFFFFFFUL) | 1;
+
+	/* the dummies are linked to each other on all the levels */
+	new_srt_list->head.data = NULL;
+	new_srt_list->head.height = SRT_LIST_MAX_LEVEL;
+	new_srt_list->head.is_pooled = 0;
+	new_srt_list->tail->data = NULL;
+	new_srt_list->tail->height = SRT_LIST_MAX_LEVEL;
+	new_srt_list->tail->is_pooled = 0;
+
+	for (i = 0; i < SRT_LIST_MAX_LEVEL; ++i)
 	{
-		free(new_srt_list); new_srt_list = NULL;
+		new_srt_list->head.links[i].prev = NULL;
+		new_srt_list->head.links[i].next = new_srt_list->tail;
+		new_srt_list->head.links[i].span = 1;
+		new_srt_list->tail->links[i].prev = &new_srt_list->head;
+		new_srt_list->tail->links[i].next = NULL;
+		new_srt_list->tail->links[i].span = 0;
+	}
+
+	return (new_srt_list);
+}
+
+struct srt_list_sort_ctx
+{
+	void *params;
+	int (*is_before)(const void *data1, const void *data2, void *params);
+};
+
+/*******************************************************************************
+IsBeforeItem() - helper function - is_before of the list over the items of
+				 the vec of data pointers.
+*******************************************************************************/
+static int IsBeforeItem(const void *item1, const void *item2, void *params)
+{
+	struct srt_list_sort_ctx *ctx = (struct srt_list_sort_ctx *)params;
+
+	return (ctx->is_before(*(void *const *)item1, *(void *const *)item2,
+						   ctx->params));
+}
+
+/*******************************************************************************
+BulkHeight() - helper function - height of the i-th node (from 1) of a list
+			   built at once: 1 + the num of zero bit pairs at the bottom of i,
+			   so the levels are evenly spaced, as a random list expects them.
+*******************************************************************************/
+static size_t BulkHeight(size_t i)
+{
+	size_t height = 1;
+
+	for (; (0 == (i & 3)) && (height < SRT_LIST_MAX_LEVEL); i >>= 2)
+	{
+		++height;
+	}
+
+	return (height);
+}
+
+/*******************************************************************************
+SrtListCreateFrom() - returns pointer to new srt_list of the n items,
+					  or NULL on faliure. items is not changed.
+					  The items are sorted once (by DynVecSort, which splits
+					  a large array across threads), unless they are sorted
+					  already. Then all the nodes are laid out in one
+					  allocation and linked in one pass.
+					  Equal items keep their order in items.
+
+Time complexity: O(n log n), O(n) if items is sorted.
+*******************************************************************************/
+srt_list_t *SrtListCreateFrom(void *params,
+							  int (*is_before)(const void *data1,
+											   const void *data2,
+											   void *params),
+							  void **items, size_t n)
+{
+	srt_list_t *new_srt_list = NULL;
+	dyn_vec_t *sorted = NULL;
+	void **data = items;
+	struct srt_list_block *block = NULL;
+	srt_list_node_t *prev = NULL;
+	char *runner = NULL;
+	size_t block_size = sizeof(struct srt_list_block);
+	size_t i = 0;
+
+	assert(is_before != NULL);
+	assert((items != NULL) || (0 == n));
+
+	new_srt_list = SrtListCreate(params, is_before);
+	if ((NULL == new_srt_list) || (0 == n))
+	{
+		return (new_srt_list);
+	}
+
+	/* a sorted input (like a reload of a dump) skips the sort */
+	for (i = 1; (i < n) && (0 == is_before(items[i], items[i - 1], params));
+		 ++i)
+	{
+		/* empty */
+	}
+
+	if (i < n)
+	{
+		struct srt_list_sort_ctx ctx;
+
+		ctx.params = params;
+		ctx.is_before = is_before;
+
+		sorted = DynVecCreate(sizeof(void *), n);
+		if (NULL == sorted)
+		{
+			SrtListDestroy(new_srt_list); new_srt_list = NULL;
+			return (NULL);
+		}
+
+		data = (void **)DynVecGetItemAddress(sorted, 0);
+		memcpy(data, items, n * sizeof(void *));
+		if (0 != DynVecSort(sorted, &ctx, IsBeforeItem))
+		{
+			DynVecDestroy(sorted); sorted = NULL;
+			SrtListDestroy(new_srt_list); new_srt_list = NULL;
+			return (NULL);
+		}
+
+		/* the vec may move its items while sorting */
+		data = (void **)DynVecGetItemAddress(sorted, 0);
+	}
+
+	for (i = 1; i <= n; ++i)
+	{
+		block_size += NodeSize(BulkHeight(i));
+	}
+
+	block = (struct srt_list_block *)malloc(block_size);
+	if (NULL == block)
+	{
+		if (NULL != sorted)
+		{
+			DynVecDestroy(sorted); sorted = NULL;
+		}
+		SrtListDestroy(new_srt_list); new_srt_list = NULL;
 		return (NULL);
 	}
-	
+
+	block->next = NULL;
+	new_srt_list->blocks = block;
+
+	/* level 0 is linked while the nodes are laid out */
+	prev = &new_srt_list->head;
+	runner = (char *)(block + 1);
+	for (i = 0; i < n; ++i)
+	{
+		srt_list_node_t *node = (srt_list_node_t *)runner;
+
+		node->data = data[i];
+		node->height = (unsigned int)BulkHeight(i + 1);
+		node->is_pooled = 1;
+		node->links[0].prev = prev;
+		prev->links[0].next = node;
+
+		prev = node;
+		runner += NodeSize(node->height);
+	}
+
+	prev->links[0].next = new_srt_list->tail;
+	new_srt_list->tail->links[0].prev = prev;
+	new_srt_list->size = n;
+	RelinkLevels(new_srt_list);
+
+	if (NULL != sorted)
+	{
+		DynVecDestroy(sorted); sorted = NULL;
+	}
+
 	return (new_srt_list);
 }
 
@@ -50,25 +661,44 @@ Time complexity: O(n).
 *******************************************************************************/
 void SrtListDestroy(srt_list_t *srt_list)
 {
+	srt_list_node_t *node = NULL;
+
 	assert(srt_list != NULL);
-	assert(srt_list->dlist != NULL);
 
-	DlistDestroy(srt_list->dlist);
-	
+	node = srt_list->head.links[0].next;
+	while (node != srt_list->tail)
+	{
+		srt_list_node_t *to_remove = node;
+
+		node = node->links[0].next;
+		if (0 == to_remove->is_pooled)
+		{
+			free(to_remove); to_remove = NULL;
+		}
+	}
+
+	while (NULL != srt_list->blocks)
+	{
+		struct srt_list_block *to_remove = srt_list->blocks;
+
+		srt_list->blocks = to_remove->next;
+		free(to_remove); to_remove = NULL;
+	}
+
+	free(srt_list->tail); srt_list->tail = NULL;
 	free(srt_list); srt_list = NULL;
 }
 
 /*******************************************************************************
 SrtListSize() - return the num of elements held in srt_list.
 
-Time complexity: O(n).
+Time complexity: O(1).
 *******************************************************************************/
 size_t SrtListSize(const srt_list_t *srt_list)
 {
 	assert(srt_list != NULL);
-	assert(srt_list->dlist != NULL);
 
-	return (DlistSize(srt_list->dlist));
+	return (srt_list->size);
 }
 
 /*******************************************************************************
@@ -79,41 +709,76 @@ Time complexity: O(1).
 int SrtListIsEmpty(const srt_list_t *srt_list)
 {
 	assert(srt_list != NULL);
-	assert(srt_list->dlist != NULL);
 
-	return (DlistIsEmpty(srt_list->dlist));
+	return (0 == srt_list->size);
 }
 
 /*******************************************************************************
 SrtListInsert() - Return iter to inserted node on success, end on failure
+				  The new node goes before the nodes equal to it.
+				  In the adaptive mode, the ends and the neighbourhood of the
+				  last inserted node are tried before searching.
 
-Time complexity: O(n).
+Time complexity: O(log n) expected. Near-sorted adaptive inserts take O(1)
+				 compares, the spans above the node still cost O(log n) steps.
 *******************************************************************************/
 srt_list_iter_t SrtListInsert(srt_list_t *srt_list, void *data)
 {
-	srt_list_iter_t iter = {0};
-	
+	srt_list_node_t *next = NULL;
+	srt_list_node_t *node = NULL;
+
 	assert(srt_list != NULL);
-	assert(srt_list->dlist != NULL);
 
-	iter = SrtListBegin(srt_list);
+	if (1 == srt_list->is_adaptive)
+	{
+		next = AdaptiveNext(srt_list, data);
+	}
 
-	/* while the srt_list is not over, and "data" is befor "data of iter" */
-	while ((0 == SrtListIsSameIter(iter, SrtListEnd(srt_list))) && 
-		   (1 == srt_list->is_before(SrtListGetData(iter), data, srt_list->params)))
+	node = InsertNode(srt_list, next, data);
+	if (NULL == node)
 	{
-		iter = SrtListNext(iter);
-	}	
-	
-	iter.info = (struct srt_list_iter_info *)DlistInsert(srt_list->dlist,
-														(dlist_iter_t)iter.info,
-														data);
-	if (NULL == iter.info)
+		return (SrtListEnd(srt_list));
+	}
+
+	return (NodeToIter(node));
+}
+
+/*******************************************************************************
+SrtListInsertHint() - Like SrtListInsert, but the place of data is looked for
+					  from hint outward. A hint far from it costs a search.
+
+Time complexity: O(distance from hint) compares, O(log n) expected steps.
+*******************************************************************************/
+srt_list_iter_t SrtListInsertHint(srt_list_t *srt_list, srt_list_iter_t hint,
+								  void *data)
+{
+	srt_list_node_t *node = NULL;
+
+	assert(srt_list != NULL);
+	assert(hint.info != NULL);
+
+	node = InsertNode(srt_list, WalkFrom(srt_list, IterToNode(hint), data,
+										 SRT_LIST_HINT_STEPS), data);
+	if (NULL == node)
 	{
-		return (iter);
-	}							
+		return (SrtListEnd(srt_list));
+	}
 
-	return (iter);
+	return (NodeToIter(node));
+}
+
+/*******************************************************************************
+SrtListSetAdaptive() - turns the adaptive mode of SrtListInsert on (1)
+					   or off (0).
+
+Time complexity: O(1).
+*******************************************************************************/
+void SrtListSetAdaptive(srt_list_t *srt_list, int is_adaptive)
+{
+	assert(srt_list != NULL);
+	assert((0 == is_adaptive) || (1 == is_adaptive));
+
+	srt_list->is_adaptive = is_adaptive;
 }
 
 /*******************************************************************************
@@ -129,17 +794,61 @@ static int IsIterValid(srt_list_iter_t iter)
 /*******************************************************************************
 SrtListRemove() - Return iter to the next node.
 
-Time complexity: O(1).
+Time complexity: O(log n) expected.
 *******************************************************************************/
 srt_list_iter_t SrtListRemove(srt_list_iter_t whom)
 {
-	srt_list_iter_t res_iter = {0};
-	
+	srt_list_node_t *update[SRT_LIST_MAX_LEVEL];
+	size_t dist[SRT_LIST_MAX_LEVEL];
+	srt_list_node_t *node = NULL;
+	srt_list_node_t *next = NULL;
+	srt_list_t *srt_list = NULL;
+	size_t i = 0;
+
 	assert(1 == IsIterValid(whom));
-	
-	res_iter.info = (struct srt_list_iter_info *)DlistErase((dlist_iter_t)whom.info);
-	
-	return (res_iter);
+
+	node = IterToNode(whom);
+
+	/* whom is a dummy head or whom is a dummy tail */
+	if ((NULL == node->links[0].prev) || (NULL == node->links[0].next))
+	{
+		return (NodeToIter(NULL));
+	}
+
+	srt_list = ListOfNode(node);
+	next = node->links[0].next;
+	ClimbPrevs(node->links[0].prev, update, dist);
+
+	for (i = 0; i < node->height; ++i)
+	{
+		update[i]->links[i].span += node->links[i].span - 1;
+		update[i]->links[i].next = node->links[i].next;
+		node->links[i].next->links[i].prev = update[i];
+	}
+
+	for (; i < SRT_LIST_MAX_LEVEL; ++i)
+	{
+		--update[i]->links[i].span;
+	}
+
+	while ((srt_list->level > 1) &&
+		   (srt_list->head.links[srt_list->level - 1].next == srt_list->tail))
+	{
+		--srt_list->level;
+	}
+
+	--srt_list->size;
+	if (srt_list->last_insert == node)
+	{
+		srt_list->last_insert = NULL;
+	}
+
+	if (0 == node->is_pooled)
+	{
+		free(node); node = NULL;
+	}
+
+	return (NodeToIter(next));
 }
 
 /*******************************************************************************
@@ -149,14 +858,9 @@ Time complexity: O(1).
 *******************************************************************************/
 srt_list_iter_t SrtListBegin(const srt_list_t *srt_list)
 {
-	srt_list_iter_t res = {0};
-	
 	assert(srt_list != NULL);
-	assert(srt_list->dlist != NULL);
-	
-	res.info = (struct srt_list_iter_info *)DlistBegin(srt_list->dlist);
 
-	return (res);
+	return (NodeToIter(srt_list->head.links[0].next));
 }
 
 /*******************************************************************************
@@ -166,16 +870,11 @@ Time complexity: O(1).
 *******************************************************************************/
 srt_list_iter_t SrtListEnd(const srt_list_t *srt_list)
 {
-	srt_list_iter_t res = {0};
-	
 	assert(srt_list != NULL);
-	assert(srt_list->dlist != NULL);
-	
-	res.info = (struct srt_list_iter_info *)DlistEnd(srt_list->dlist);
 
-	return (res);
+	return (NodeToIter(srt_list->tail));
 }
-	
+
 /*******************************************************************************
 SrtListPrev() - return the previous node of the givev current
 
@@ -183,13 +882,9 @@ Time complexity: O(1).
 *******************************************************************************/
 srt_list_iter_t SrtListPrev(srt_list_iter_t current)
 {
-	srt_list_iter_t res = {0};
-	
 	assert(1 == IsIterValid(current));
-	
-	res.info = (struct srt_list_iter_info *)DlistPrev((dlist_iter_t)current.info);
 
-	return (res);
+	return (NodeToIter(IterToNode(current)->links[0].prev));
 }
 
 /*******************************************************************************
@@ -199,13 +894,9 @@ Time complexity: O(1).
 *******************************************************************************/
 srt_list_iter_t SrtListNext(srt_list_iter_t current)
 {
-	srt_list_iter_t res = {0};
-	
 	assert(1 == IsIterValid(current));
 
-	res.info = (struct srt_list_iter_info *)DlistNext((dlist_iter_t)current.info);
-
-	return (res);
+	return (NodeToIter(IterToNode(current)->links[0].next));
 }
 
 /*******************************************************************************
@@ -216,10 +907,10 @@ Time complexity: O(1).
 void *SrtListGetData(srt_list_iter_t iter)
 {
 	assert(1 == IsIterValid(iter));
-	
-	return (DlistGetData((dlist_iter_t)iter.info));
+
+	return (IterToNode(iter)->data);
 }
-	
+
 /*******************************************************************************
 SrtListIsSameIter() - returns 1 if iter1 and iter2 is the same, and 0 if not.
 
@@ -227,49 +918,80 @@ Time complexity: O(1).
 *******************************************************************************/
 int SrtListIsSameIter(srt_list_iter_t iter1, srt_list_iter_t iter2)
 {
-	assert(1 == IsIterValid(iter1));	
+	assert(1 == IsIterValid(iter1));
 	assert(1 == IsIterValid(iter2));
 
-	return (DlistIsSameIter((dlist_iter_t)iter1.info, (dlist_iter_t)iter2.info));
+	return (iter1.info == iter2.info);
 }
 
 /*******************************************************************************
-SrtListForEach() - iterate through the sorted list.									
+SrtListForEach() - iterate through the sorted list.
 					returns the value of do_func:
 					if the value is a non-zero, stops iterations
 
 Time complexity: O(n).
 *******************************************************************************/
-int SrtListForEach(srt_list_iter_t from,									
-					srt_list_iter_t to,					
-					void *params,					
+int SrtListForEach(srt_list_iter_t from,
+					srt_list_iter_t to,
+					void *params,
 					int (*do_func)(void *data, void *params))
 {
+	srt_list_node_t *node = NULL;
+	srt_list_node_t *end = NULL;
+
 	assert(1 == IsIterValid(from));
 	assert(1 == IsIterValid(to));
 	assert(do_func != NULL);
 
-	return (DlistForEach((dlist_iter_t)from.info, (dlist_iter_t)to.info,
-						  do_func,
-						  params));
+	end = IterToNode(to);
+	for (node = IterToNode(from); node != end; node = node->links[0].next)
+	{
+		int res = do_func(node->data, params);
+		if (res != 0)
+		{
+			return (res);
+		}
+	}
+
+	return (0);
 }
 
 /*******************************************************************************
 SrtListFind() - returns the iterator to the first node contains the searched data.
 				returns 'to' if didn't find.
-Time complexity: O(n).
+				On the whole list (begin to end) it searches down the levels,
+				on a part of the list it scans from 'from'.
+
+Time complexity: O(log n) expected on the whole list, O(n) otherwise.
 *******************************************************************************/
-srt_list_iter_t SrtListFind(srt_list_t *srt_list,									
-							srt_list_iter_t from,		
-							srt_list_iter_t to,		
+srt_list_iter_t SrtListFind(srt_list_t *srt_list,
+							srt_list_iter_t from,
+							srt_list_iter_t to,
 							const void *to_find)
 {
 	assert(1 == IsIterValid(from));
 	assert(1 == IsIterValid(to));
 	assert(srt_list != NULL);
 
+	if ((1 == SrtListIsSameIter(from, SrtListBegin(srt_list))) &&
+		(1 == SrtListIsSameIter(to, SrtListEnd(srt_list))))
+	{
+		srt_list_node_t *update[SRT_LIST_MAX_LEVEL];
+		size_t rank[SRT_LIST_MAX_LEVEL];
+		srt_list_node_t *found = FindPrevs(srt_list, to_find, 0, update, rank);
+
+		/* found is not before to_find; equal if to_find is not before it */
+		if ((found != srt_list->tail) &&
+			(0 == srt_list->is_before(to_find, found->data, srt_list->params)))
+		{
+			return (NodeToIter(found));
+		}
+
+		return (to);
+	}
+
 	while (0 == SrtListIsSameIter(from, to))
-	{	   
+	{
 		/* If each one is before the other, it's the same data */
 		if (0 == (srt_list->is_before(SrtListGetData(from), to_find, srt_list->params)))
 		{
@@ -279,24 +1001,24 @@ srt_list_iter_t SrtListFind(srt_list_t *srt_list,
 			}
 			return (to);
 		}
-		
-		from = SrtListNext(from);	
+
+		from = SrtListNext(from);
 	}
-	
+
 	return (to);
 }
 
 /*******************************************************************************
-SrtListFindIf() - returns the iterator to the first node contains the searched data 
+SrtListFindIf() - returns the iterator to the first node contains the searched data
 				  returns 'to' if didn't find.
 
 Time complexity: O(n).
 *******************************************************************************/
-srt_list_iter_t SrtListFindIf(srt_list_iter_t from,	srt_list_iter_t to,				
-						   	const void *to_find,			
-							void *params,				
-							int (*is_match)(const void *node_data,					
-											const void *to_find,	
+srt_list_iter_t SrtListFindIf(srt_list_iter_t from,	srt_list_iter_t to,
+						   	const void *to_find,
+							void *params,
+							int (*is_match)(const void *node_data,
+											const void *to_find,
 											void *params))
 {
 	assert(1 == IsIterValid(from));
@@ -313,48 +1035,334 @@ srt_list_iter_t SrtListFindIf(srt_list_iter_t from,	srt_list_iter_t to,
 	return (from);
 }
 
+/*******************************************************************************
+SrtListLowerBound() - returns the first node which is not before data,
+					  or end if there is none.
+
+Time complexity: O(log n) expected.
+*******************************************************************************/
+srt_list_iter_t SrtListLowerBound(const srt_list_t *srt_list, const void *data)
+{
+	srt_list_node_t *update[SRT_LIST_MAX_LEVEL];
+	size_t rank[SRT_LIST_MAX_LEVEL];
+
+	assert(srt_list != NULL);
+
+	return (NodeToIter(FindPrevs(srt_list, data, 0, update, rank)));
+}
+
+/*******************************************************************************
+SrtListUpperBound() - returns the first node which data is before,
+					  or end if there is none.
+
+Time complexity: O(log n) expected.
+*******************************************************************************/
+srt_list_iter_t SrtListUpperBound(const srt_list_t *srt_list, const void *data)
+{
+	srt_list_node_t *update[SRT_LIST_MAX_LEVEL];
+	size_t rank[SRT_LIST_MAX_LEVEL];
+
+	assert(srt_list != NULL);
+
+	return (NodeToIter(FindPrevs(srt_list, data, 1, update, rank)));
+}
+
+/*******************************************************************************
+SrtListRank() - returns the num of nodes before data, which is the index
+				of SrtListLowerBound(data) from begin.
+
+Time complexity: O(log n) expected.
+*******************************************************************************/
+size_t SrtListRank(const srt_list_t *srt_list, const void *data)
+{
+	srt_list_node_t *update[SRT_LIST_MAX_LEVEL];
+	size_t rank[SRT_LIST_MAX_LEVEL];
+
+	assert(srt_list != NULL);
+
+	FindPrevs(srt_list, data, 0, update, rank);
+
+	return (rank[0]);
+}
+
+/*******************************************************************************
+SrtListRangeCount() - returns the num of nodes which are not before lo,
+					  and are before hi.
+
+Time complexity: O(log n) expected.
+*******************************************************************************/
+size_t SrtListRangeCount(const srt_list_t *srt_list, const void *lo,
+						 const void *hi)
+{
+	size_t lo_rank = 0;
+	size_t hi_rank = 0;
+
+	assert(srt_list != NULL);
+
+	lo_rank = SrtListRank(srt_list, lo);
+	hi_rank = SrtListRank(srt_list, hi);
+
+	return ((hi_rank > lo_rank) ? (hi_rank - lo_rank) : 0);
+}
+
+/*******************************************************************************
+SrtListNth() - returns the node at index (from 0), or end if index is not
+			   less than the size.
+			   Goes down the levels, passing the links which span
+			   no further than index.
+
+Time complexity: O(log n) expected.
+*******************************************************************************/
+srt_list_iter_t SrtListNth(const srt_list_t *srt_list, size_t index)
+{
+	srt_list_node_t *node = NULL;
+	size_t rank = 0;
+	size_t i = 0;
+
+	assert(srt_list != NULL);
+
+	if (index >= srt_list->size)
+	{
+		return (SrtListEnd(srt_list));
+	}
+
+	node = (srt_list_node_t *)&srt_list->head;
+	for (i = srt_list->level; i > 0; --i)
+	{
+		while ((node->links[i - 1].next != srt_list->tail) &&
+			   (rank + node->links[i - 1].span <= index + 1))
+		{
+			rank += node->links[i - 1].span;
+			node = node->links[i - 1].next;
+		}
+	}
+
+	return (NodeToIter(node));
+}
+
 /*******************************************************************************
 SrtListPopBack() - pops out the last node of the list and returns its data
 
-Time complexity: O(1).
-*******************************************************************************/									
+Time complexity: O(log n) expected.
+*******************************************************************************/
 void *SrtListPopBack(srt_list_t *srt_list)
 {
-	assert(srt_list != NULL);	
-	assert(srt_list->dlist != NULL);
+	void *data = NULL;
+
+	assert(srt_list != NULL);
+
+	if (0 == SrtListIsEmpty(srt_list))
+	{
+		srt_list_iter_t last = SrtListPrev(SrtListEnd(srt_list));
+
+		data = SrtListGetData(last);
+		SrtListRemove(last);
+	}
 
-	return ( DlistPopBack(srt_list->dlist));
+	return (data);
 }
 
 /*******************************************************************************
 SrtListPopFront() - pops out the first node of the list and returns its data
 
-Time complexity: O(1).
+Time complexity: O(1) expected.
 *******************************************************************************/
 void *SrtListPopFront(srt_list_t *srt_list)
-{	
+{
+	void *data = NULL;
+
 	assert(srt_list != NULL);
-	assert(srt_list->dlist != NULL);
 
-	return ( DlistPopFront(srt_list->dlist));
+	if (0 == SrtListIsEmpty(srt_list))
+	{
+		srt_list_iter_t first = SrtListBegin(srt_list);
+
+		data = SrtListGetData(first);
+		SrtListRemove(first);
+	}
+
+	return (data);
+}
+
+/*******************************************************************************
+MoveBlocks() - helper function - dest takes the node blocks of src.
+
+Time complexity: O(num of blocks of src).
+*******************************************************************************/
+static void MoveBlocks(srt_list_t *dest, srt_list_t *src)
+{
+	struct srt_list_block *last = src->blocks;
+
+	if (NULL == last)
+	{
+		return;
+	}
+
+	while (NULL != last->next)
+	{
+		last = last->next;
+	}
+
+	last->next = dest->blocks;
+	dest->blocks = src->blocks;
+	src->blocks = NULL;
+}
+
+/*******************************************************************************
+MakeEmpty() - helper function - links the dummies of srt_list to each other,
+			  without freeing (the nodes were moved to another list).
+
+Time complexity: O(1).
+*******************************************************************************/
+static void MakeEmpty(srt_list_t *srt_list)
+{
+	size_t i = 0;
+
+	for (i = 0; i < SRT_LIST_MAX_LEVEL; ++i)
+	{
+		srt_list->head.links[i].next = srt_list->tail;
+		srt_list->head.links[i].span = 1;
+		srt_list->tail->links[i].prev = &srt_list->head;
+	}
+
+	srt_list->size = 0;
+	srt_list->level = 1;
+	srt_list->last_insert = NULL;
+}
+
+/*******************************************************************************
+MoveNodes() - helper function - moves the nodes of src into dest one by one,
+			  searching down the levels of dest for each (no allocation).
+			  For a src much smaller than dest.
+
+Time complexity: O(n2 * log(n1 + n2)) expected.
+*******************************************************************************/
+static void MoveNodes(srt_list_t *dest, srt_list_t *src)
+{
+	srt_list_node_t *update[SRT_LIST_MAX_LEVEL];
+	size_t dist[SRT_LIST_MAX_LEVEL];
+	srt_list_node_t *node = src->head.links[0].next;
+
+	while (node != src->tail)
+	{
+		srt_list_node_t *next = node->links[0].next;
+
+		FindPrevs(dest, node->data, 0, update, dist);
+		RanksToDists(dist);
+		if (dest->level < node->height)
+		{
+			dest->level = node->height;
+		}
+
+		LinkNode(node, update, dist);
+		++dest->size;
+		node = next;
+	}
 }
 
 /*******************************************************************************
 SrtListMerge() - Merges to lists into one sorted list (which is dest).
-				 src becomes empty.
+				 src becomes empty. The nodes of src move to dest, so nothing
+				 is allocated or freed, and the iterators stay valid.
+				 A node of src goes before the nodes of dest equal to it,
+				 like SrtListInsert.
+				 Level 0 is merged by a two-finger walk over both lists,
+				 then the levels above it are relinked in one pass.
+				 A src much smaller than dest is inserted node by node instead.
 
-Time complexity: O(n1*n2).
+Time complexity: O(n1 + n2), or O(n2 * log(n1 + n2)) for a small src.
 *******************************************************************************/
 void SrtListMerge(srt_list_t *dest, srt_list_t *src)
 {
+	srt_list_node_t *prev = NULL;
+	srt_list_node_t *a = NULL;
+	srt_list_node_t *b = NULL;
+
 	assert(dest != NULL);
 	assert(src != NULL);
-	
-	while (0 == SrtListIsEmpty(src))
+	assert(dest != src);
+
+	if (SrtListIsEmpty(src))
+	{
+		return;
+	}
+
+	if (src->size * SRT_LIST_MAX_LEVEL < dest->size)
+	{
+		MoveNodes(dest, src);
+		MoveBlocks(dest, src);
+		MakeEmpty(src);
+		return;
+	}
+
+	prev = &dest->head;
+	a = dest->head.links[0].next;
+	b = src->head.links[0].next;
+
+	while ((a != dest->tail) && (b != src->tail))
+	{
+		srt_list_node_t **from = &a;
+
+		if (0 == dest->is_before(a->data, b->data, dest->params))
+		{
+			from = &b;
+		}
+
+		prev->links[0].next = *from;
+		(*from)->links[0].prev = prev;
+		prev = *from;
+		*from = (*from)->links[0].next;
+	}
+
+	/* the rest of src, if any, goes to the end */
+	if (b != src->tail)
+	{
+		prev->links[0].next = b;
+		b->links[0].prev = prev;
+		prev = src->tail->links[0].prev;
+	}
+	else if (a != dest->tail)
 	{
-		SrtListInsert(dest, SrtListPopFront(src));
+		prev->links[0].next = a;
+		a->links[0].prev = prev;
+		prev = dest->tail->links[0].prev;
 	}
+
+	prev->links[0].next = dest->tail;
+	dest->tail->links[0].prev = prev;
+
+	dest->size += src->size;
+	MoveBlocks(dest, src);
+	MakeEmpty(src);
+	RelinkLevels(dest);
 }
 
+/*******************************************************************************
+SrtListMergeMany() - Merges num_srcs lists into dest, all srcs become empty.
+					 The srcs are merged in pairs, then the pairs in pairs...
+
+Time complexity: O(N * log(num_srcs)), N is the num of all elements.
+*******************************************************************************/
+void SrtListMergeMany(srt_list_t *dest, srt_list_t **srcs, size_t num_srcs)
+{
+	size_t step = 0;
+	size_t i = 0;
 
+	assert(dest != NULL);
+	assert((srcs != NULL) || (0 == num_srcs));
 
+	if (0 == num_srcs)
+	{
+		return;
+	}
+
+	for (step = 1; step < num_srcs; step *= 2)
+	{
+		for (i = 0; i + step < num_srcs; i += 2 * step)
+		{
+			SrtListMerge(srcs[i], srcs[i + step]);
+		}
+	}
+
+	SrtListMerge(dest, srcs[0]);
+}
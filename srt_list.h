@@ -3,8 +3,6 @@
 									
 #include <stddef.h> /* for size_t */									
 
-#include "dlist.h"
-
 
 typedef struct srt_list srt_list_t;	
 
@@ -16,6 +14,12 @@ typedef struct srt_list_iter
 srt_list_t *SrtListCreate(void *params,									
 						int (*is_before)(const void *data1,	const void *data2, void *params));		
 													
+/* A new list of the n items (items is not changed), or NULL on failure.
+   Sorts once and links all the nodes in one pass, O(n log n) */
+srt_list_t *SrtListCreateFrom(void *params,
+							  int (*is_before)(const void *data1, const void *data2, void *params),
+							  void **items, size_t n);
+
 void SrtListDestroy(srt_list_t *srt_list);									
 									
 size_t SrtListSize(const srt_list_t *srt_list);									
@@ -25,6 +29,13 @@ int SrtListIsEmpty(const srt_list_t *srt_list);
 /* Return iter to inserted node on success, end on failure */									
 srt_list_iter_t SrtListInsert(srt_list_t *srt_list, void *data);									
 									
+/* Like SrtListInsert, searches from hint outward (near-sorted inserts) */
+srt_list_iter_t SrtListInsertHint(srt_list_t *srt_list, srt_list_iter_t hint,
+								  void *data);
+
+/* 1 - SrtListInsert tries the ends and the last inserted place first, 0 - off */
+void SrtListSetAdaptive(srt_list_t *srt_list, int is_adaptive);
+
 /* Return iter to the next node */									
 srt_list_iter_t SrtListRemove(srt_list_iter_t whom);									
 									
@@ -61,12 +72,31 @@ srt_list_iter_t SrtListFindIf(srt_list_iter_t from,
 										const void *to_find,	
 										void *params));		
 																		
+/* the first node which is not before data, or end. O(log n) */
+srt_list_iter_t SrtListLowerBound(const srt_list_t *srt_list, const void *data);
+
+/* the first node which data is before, or end. O(log n) */
+srt_list_iter_t SrtListUpperBound(const srt_list_t *srt_list, const void *data);
+
+/* the num of nodes before data (the index of the lower bound). O(log n) */
+size_t SrtListRank(const srt_list_t *srt_list, const void *data);
+
+/* the num of nodes in [lo, hi): not before lo and before hi. O(log n) */
+size_t SrtListRangeCount(const srt_list_t *srt_list, const void *lo,
+						 const void *hi);
+
+/* the node at index (from 0), or end if index >= size. O(log n) */
+srt_list_iter_t SrtListNth(const srt_list_t *srt_list, size_t index);
+
 void *SrtListPopBack(srt_list_t *srt_list);
 									
 void *SrtListPopFront(srt_list_t *srt_list);									
 									
-/* src becomes empty */									
+/* src becomes empty. No allocation, O(n1 + n2) */									
 void SrtListMerge(srt_list_t *dest, srt_list_t *src);
+
+/* all srcs become empty. O(N log num_srcs) */
+void SrtListMergeMany(srt_list_t *dest, srt_list_t **srcs, size_t num_srcs);
 								
 
 #endif /* SRT_LIST_H_ */
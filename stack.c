@@ -6,12 +6,37 @@
 struct stack
 {
 	void *top;
+	void *end;		/* start + size_of_element * max_of_elements */
 	size_t size_of_element;
 	size_t max_of_elements;
 	char start[1];
 };
 
 
+/****************************************************************
+Helper function - copies one element. The common sizes get a
+constant size memcpy, which compiles to a single load and store.
+****************************************************************/
+static void CopyElement(void *dest, const void *src, size_t size)
+{
+	switch (size)
+	{
+		case 4:
+			memcpy(dest, src, 4);
+			break;
+		case 8:
+			memcpy(dest, src, 8);
+			break;
+		case 16:
+			memcpy(dest, src, 16);
+			break;
+		default:
+			memcpy(dest, src, size);
+			break;
+	}
+}
+
+
 /****************************************************************
 Resived element_size and max_elements, and return pointer to Stack,
 if the allocation is fail return NULL
@@ -33,6 +58,8 @@ stack_t *StackCreate(size_t element_size, size_t max_elements)
 	
 	/* Initializing details of the Stack */
 	new_stack->top = (void *)new_stack->start;
+	new_stack->end = (void *)(new_stack->start + 
+							  (element_size * max_elements));
 	new_stack->size_of_element = element_size;
 	new_stack->max_of_elements = max_elements;
 
@@ -58,22 +85,16 @@ return 0 if sucsses, and -1 in overflowe case.
 ****************************************************************/
 int StackPush(stack_t *stack, const void *element)
 {
-	void *tmp = NULL;
-
 	assert(NULL != element);
 	assert(NULL != stack);
 		
-	/* check overflowe */
-	if (StackSize(stack) == stack->max_of_elements)
+	/* check overflowe - against the cached end, no division */
+	if (stack->top == stack->end)
 	{
 		return (-1);
 	}
 	
-	tmp = memcpy(stack->top, element, stack->size_of_element);
-	if(tmp == NULL)
-	{
-		return (-1);
-	}
+	CopyElement(stack->top, element, stack->size_of_element);
 	
 	stack->top = (void *)((size_t)stack->top + stack->size_of_element);
 
@@ -49,5 +49,20 @@ uuid_t UuidGetInvalidID(void)
 	return (res);	
 }
 
+/*******************************************************************************
+UuidHash() - return a hash of all the fields of uid.
+			 Every field is multiplied into the hash, the counter last, so
+			 ids of the same process and second still differ in the low bits.
 
+Time complexity: O(1).
+*******************************************************************************/
+size_t UuidHash(uuid_t uid)
+{
+	size_t hash = (size_t)uid.pid;
 
+	hash = (hash * 0x01000193UL) ^ (size_t)uid.time.tv_sec;
+	hash = (hash * 0x01000193UL) ^ (size_t)uid.time.tv_usec;
+	hash = (hash * 0x01000193UL) ^ uid.ctr;
+
+	return (hash);
+}
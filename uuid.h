@@ -19,4 +19,7 @@ int UuidIsequal(uuid_t uid1, uuid_t uid2);
 				
 uuid_t UuidGetInvalidID(void);
 
+/* hash of all the fields of uid, for hash tables */
+size_t UuidHash(uuid_t uid);
+
 #endif /* UUID_H_ */    